@@ -0,0 +1,82 @@
+'use strict';
+const fs = require('fs');
+const path = require('path');
+const runner = require('./runner');
+
+const usage = `Usage: node --expose-gc benchmark [suite...] [options]
+
+Options:
+  --json             print results as JSON (for comparing builds)
+  --filter <regex>   only run cases whose name matches
+  --duration <ms>    measured time per case (default: 500)
+  --warmup <ms>      warmup time per case (default: 100)
+`;
+
+const parseArgs = (argv) => {
+	const options = { suites: [], json: false, filter: null, duration: 500, warmup: 100 };
+	for (let i = 0; i < argv.length; ++i) {
+		const arg = argv[i];
+		if (arg === '--json') options.json = true;
+		else if (arg === '--filter') options.filter = new RegExp(argv[++i]);
+		else if (arg === '--duration') options.duration = Number(argv[++i]);
+		else if (arg === '--warmup') options.warmup = Number(argv[++i]);
+		else if (arg === '--help' || arg === '-h') { process.stdout.write(usage); process.exit(0); }
+		else if (arg.startsWith('-')) throw new TypeError(`Unknown option: ${arg}`);
+		else options.suites.push(arg);
+	}
+	if (!(options.duration > 0) || !(options.warmup >= 0)) throw new TypeError('Invalid duration or warmup');
+	return options;
+};
+
+const listSuites = () => fs.readdirSync(path.join(__dirname, 'suites'))
+	.filter(filename => filename.endsWith('.js'))
+	.map(filename => filename.slice(0, -3));
+
+const pad = (value, width) => String(value).padStart(width);
+const format = (number, digits) => number.toLocaleString('en-US', { maximumFractionDigits: digits });
+
+const printHeader = (suite) => {
+	process.stdout.write(`\n${suite}\n`);
+	process.stdout.write(`${'case'.padEnd(40)}${pad('ops/sec', 16)}${pad('ns/op', 14)}${pad('heap KB/Mop', 16)}${pad('GCs/Mop', 12)}${pad('GC ms/Mop', 14)}\n`);
+};
+
+const printResult = (result) => {
+	process.stdout.write(
+		result.name.padEnd(40)
+		+ pad(format(result.opsPerSec, 0), 16)
+		+ pad(format(result.nsPerOp, 1), 14)
+		+ pad(format(result.heapBytesPerMillion / 1024, 0), 16)
+		+ pad(format(result.gcCountPerMillion, 1), 12)
+		+ pad(format(result.gcMsPerMillion, 2), 14)
+		+ '\n'
+	);
+};
+
+const main = async () => {
+	const options = parseArgs(process.argv.slice(2));
+	const suites = options.suites.length ? options.suites : listSuites();
+	if (typeof global.gc !== 'function' && !options.json) {
+		process.stderr.write('warning: run with --expose-gc for accurate heap measurements\n');
+	}
+
+	const output = {
+		node: process.version,
+		v8: process.versions.v8,
+		platform: process.platform,
+		arch: process.arch,
+		exposedGc: typeof global.gc === 'function',
+		duration: options.duration,
+		suites: {},
+	};
+	for (const suite of suites) {
+		const cases = require(`./suites/${suite}`);
+		if (!options.json) printHeader(suite);
+		output.suites[suite] = await runner.run(cases, options, options.json ? null : printResult);
+	}
+	if (options.json) process.stdout.write(JSON.stringify(output, null, '\t') + '\n');
+};
+
+main().catch((err) => {
+	process.stderr.write(`${err.stack}\n`);
+	process.exitCode = 1;
+});
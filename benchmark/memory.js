@@ -0,0 +1,90 @@
+'use strict';
+const { PerformanceObserver } = require('perf_hooks');
+const Integer = require('..');
+
+// Measures the memory cost of keeping many Integers alive at once, and the
+// garbage collection pauses that they cause. Values are chosen outside of the
+// range of shared instances so that every Integer is a distinct object.
+//   node --expose-gc --max-old-space-size=8192 benchmark/memory.js [count] [--json]
+
+const args = process.argv.slice(2);
+const json = args.includes('--json');
+const count = Number(args.find(arg => !arg.startsWith('-')) || 10000000);
+if (!Number.isInteger(count) || count <= 0) throw new TypeError('Invalid count');
+if (typeof global.gc !== 'function') throw new Error('Run with --expose-gc');
+
+const pauses = [];
+const observer = new PerformanceObserver((list) => {
+	for (const entry of list.getEntries()) pauses.push(entry.duration);
+});
+observer.observe({ entryTypes: ['gc'] });
+
+const flush = () => new Promise(resolve => setTimeout(resolve, 10));
+const usage = () => {
+	global.gc();
+	const { heapUsed, rss, external } = process.memoryUsage();
+	return { heapUsed, rss, external };
+};
+const summarize = (durations) => {
+	const sorted = durations.slice().sort((a, b) => a - b);
+	const total = sorted.reduce((sum, duration) => sum + duration, 0);
+	return {
+		count: sorted.length,
+		totalMs: total,
+		maxMs: sorted.length ? sorted[sorted.length - 1] : 0,
+		p99Ms: sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * 0.99))] : 0,
+	};
+};
+
+const main = async () => {
+	const before = usage();
+	await flush();
+	pauses.length = 0;
+
+	const start = process.hrtime();
+	const live = new Array(count);
+	let int = Integer(1000000);
+	for (let i = 0; i < count; ++i) live[i] = int = int.add(1);
+	const [seconds, nanoseconds] = process.hrtime(start);
+	await flush();
+	const allocation = summarize(pauses);
+
+	const after = usage();
+	pauses.length = 0;
+	const fullGcStart = process.hrtime();
+	global.gc();
+	const [fullSeconds, fullNanoseconds] = process.hrtime(fullGcStart);
+
+	live.length = 0;
+	const released = usage();
+	await flush();
+
+	// The array holding the Integers costs 8 bytes per element on 64-bit
+	// platforms, which is not part of the cost of an Integer itself.
+	const arrayBytes = count * 8;
+	const result = {
+		node: process.version,
+		count,
+		createMs: seconds * 1e3 + nanoseconds / 1e6,
+		heapBytesPerInstance: (after.heapUsed - before.heapUsed - arrayBytes) / count,
+		rssBytesPerInstance: (after.rss - before.rss - arrayBytes) / count,
+		gcWhileCreating: allocation,
+		fullGcWithLiveMs: fullSeconds * 1e3 + fullNanoseconds / 1e6,
+		heapReleasedBytes: after.heapUsed - released.heapUsed,
+	};
+	observer.disconnect();
+
+	if (json) return process.stdout.write(JSON.stringify(result, null, '\t') + '\n');
+	const format = (number, digits) => number.toLocaleString('en-US', { maximumFractionDigits: digits });
+	process.stdout.write(`${format(count, 0)} live Integers (node ${process.version})\n`);
+	process.stdout.write(`  created in:            ${format(result.createMs, 0)} ms\n`);
+	process.stdout.write(`  V8 heap per instance:  ${format(result.heapBytesPerInstance, 1)} bytes\n`);
+	process.stdout.write(`  RSS per instance:      ${format(result.rssBytesPerInstance, 1)} bytes\n`);
+	process.stdout.write(`  GCs while creating:    ${allocation.count} (total ${format(allocation.totalMs, 0)} ms, max ${format(allocation.maxMs, 1)} ms, p99 ${format(allocation.p99Ms, 1)} ms)\n`);
+	process.stdout.write(`  full GC with all live: ${format(result.fullGcWithLiveMs, 1)} ms\n`);
+};
+
+main().catch((err) => {
+	process.stderr.write(`${err.stack}\n`);
+	process.exitCode = 1;
+});
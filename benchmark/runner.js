@@ -0,0 +1,101 @@
+'use strict';
+const { PerformanceObserver } = require('perf_hooks');
+
+const PROBE_OPS = 10000;
+const BATCH_OPS = 1000;
+
+const now = () => {
+	const [seconds, nanoseconds] = process.hrtime();
+	return seconds * 1e9 + nanoseconds;
+};
+
+const collectGarbage = () => {
+	if (typeof global.gc === 'function') global.gc();
+};
+
+// GC entries are delivered asynchronously (from a later event loop phase
+// than setImmediate), so we wait briefly before reading them back.
+const flush = () => new Promise(resolve => setTimeout(resolve, 10));
+
+class GcTracker {
+	constructor() {
+		this.count = 0;
+		this.duration = 0;
+		this.observer = new PerformanceObserver((list) => {
+			for (const entry of list.getEntries()) {
+				this.count += 1;
+				this.duration += entry.duration;
+			}
+		});
+		this.observer.observe({ entryTypes: ['gc'] });
+	}
+	async snapshot() {
+		await flush();
+		return { count: this.count, duration: this.duration };
+	}
+	close() {
+		this.observer.disconnect();
+	}
+}
+
+let sink;
+
+// Measures how many bytes of V8 heap a single operation leaves behind. The
+// probe is small enough to fit in the young generation, so the delta is not
+// hidden by a scavenge in the middle of the measurement.
+const probeHeap = (fn) => {
+	collectGarbage();
+	const before = process.memoryUsage().heapUsed;
+	for (let i = 0; i < PROBE_OPS; ++i) sink = fn();
+	const after = process.memoryUsage().heapUsed;
+	return Math.max(0, after - before) / PROBE_OPS;
+};
+
+const measure = async (testCase, options, gc) => {
+	const fn = testCase.fn;
+	const warmupEnd = now() + options.warmup * 1e6;
+	while (now() < warmupEnd) {
+		for (let i = 0; i < BATCH_OPS; ++i) sink = fn();
+	}
+
+	const bytesPerOp = probeHeap(fn);
+	collectGarbage();
+	const gcBefore = await gc.snapshot();
+
+	let ops = 0;
+	const start = now();
+	const end = start + options.duration * 1e6;
+	let elapsed;
+	do {
+		for (let i = 0; i < BATCH_OPS; ++i) sink = fn();
+		ops += BATCH_OPS;
+	} while ((elapsed = now() - start) < end - start);
+
+	const gcAfter = await gc.snapshot();
+	const perMillion = 1e6 / ops;
+	return {
+		name: testCase.name,
+		ops,
+		opsPerSec: ops / (elapsed / 1e9),
+		nsPerOp: elapsed / ops,
+		heapBytesPerMillion: bytesPerOp * 1e6,
+		gcCountPerMillion: (gcAfter.count - gcBefore.count) * perMillion,
+		gcMsPerMillion: (gcAfter.duration - gcBefore.duration) * perMillion,
+	};
+};
+
+exports.run = async (cases, options, report) => {
+	const gc = new GcTracker();
+	const results = [];
+	try {
+		for (const testCase of cases) {
+			if (options.filter && !options.filter.test(testCase.name)) continue;
+			const result = await measure(testCase, options, gc);
+			results.push(result);
+			if (report) report(result);
+		}
+	} finally {
+		gc.close();
+	}
+	return results;
+};
@@ -0,0 +1,122 @@
+'use strict';
+const Integer = require('../..');
+
+// Each operation here processes a whole array, so ns/op is per array.
+const LENGTH = 10000;
+const values = [];
+for (let i = 0; i < LENGTH; ++i) values.push((i + 1) * 7919);
+const integers = values.map(value => Integer(value));
+const a = Integer.Array.from(values);
+const b = Integer.Array.from(values.slice().reverse());
+
+const cases = [];
+const add = (name, fn) => cases.push({ name, fn });
+
+add(`Integer#add() loop x${LENGTH}`, () => {
+	let last;
+	for (let i = 0; i < LENGTH; ++i) last = integers[i].add(integers[LENGTH - 1 - i]);
+	return last;
+});
+add(`Integer#add() sum x${LENGTH}`, () => {
+	let sum = Integer.ZERO;
+	for (let i = 0; i < LENGTH; ++i) sum = sum.add(integers[i]);
+	return sum;
+});
+add(`Integer.Accumulator#add() x${LENGTH}`, () => {
+	const acc = new Integer.Accumulator();
+	for (let i = 0; i < LENGTH; ++i) acc.add(integers[i]);
+	return acc.toInteger();
+});
+add(`Integer.Accumulator#add(smi) x${LENGTH}`, () => {
+	const acc = new Integer.Accumulator();
+	for (let i = 0; i < LENGTH; ++i) acc.add(values[i]);
+	return acc.toInteger();
+});
+add(`Integer.Accumulator#addAll(array) x${LENGTH}`, () => new Integer.Accumulator().addAll(values).toInteger());
+for (const method of ['add', 'subtract', 'multiply', 'divide', 'and', 'xor', 'lessThan']) {
+	add(`Integer.Array#${method}(array) x${LENGTH}`, () => a[method](b));
+	add(`Integer.Array#${method}(smi) x${LENGTH}`, () => a[method](3));
+}
+add(`Integer.Array#shiftLeft() x${LENGTH}`, () => a.shiftLeft(3));
+for (const method of ['sum', 'min', 'max', 'countNonZero']) {
+	add(`Integer.Array#${method}() x${LENGTH}`, () => a[method]());
+}
+
+// The shuffled values are a permutation, so every sort does the same work.
+const shuffled = integers.map((_, i) => integers[i * 7757 % LENGTH]);
+const unsorted = Integer.Array.from(shuffled);
+const odd = Integer.Array.from(values.filter((_, i) => i % 2));
+add(`Array#sort(compare) x${LENGTH}`, () => shuffled.slice().sort((x, y) => x.compare(y)));
+for (const method of ['sort', 'argsort', 'unique']) {
+	add(`Integer.Array#${method}() x${LENGTH}`, () => unsorted[method]());
+}
+add(`Integer.Array#binarySearch() x${LENGTH}`, () => {
+	let found;
+	for (let i = 0; i < LENGTH; ++i) found = a.binarySearch(values[i]);
+	return found;
+});
+for (const method of ['intersection', 'union', 'difference']) {
+	add(`Integer.Array#${method}() x${LENGTH}`, () => a[method](odd));
+}
+
+// Looks up every Integer once, either by its string or natively.
+const byString = new Map(integers.map((integer, i) => [integer.toString(), i]));
+const byInteger = new Integer.Map(integers.map((integer, i) => [integer, i]));
+const idSet = new Integer.Set(a);
+add(`Map#get(toString()) x${LENGTH}`, () => {
+	let found;
+	for (let i = 0; i < LENGTH; ++i) found = byString.get(shuffled[i].toString());
+	return found;
+});
+add(`Integer.Map#get() x${LENGTH}`, () => {
+	let found;
+	for (let i = 0; i < LENGTH; ++i) found = byInteger.get(shuffled[i]);
+	return found;
+});
+add(`Integer.Set#has() x${LENGTH}`, () => {
+	let found;
+	for (let i = 0; i < LENGTH; ++i) found = idSet.has(shuffled[i]);
+	return found;
+});
+add(`Integer.Map#set() x${LENGTH}`, () => {
+	const map = new Integer.Map();
+	for (let i = 0; i < LENGTH; ++i) map.set(integers[i], i);
+	return map;
+});
+
+const text = Buffer.alloc(LENGTH * 21);
+add(`Integer#toString() join x${LENGTH}`, () => integers.join(','));
+add(`Integer.Array#writeText() x${LENGTH}`, () => a.writeText(text));
+
+const fixed = Buffer.alloc(LENGTH * 8);
+const varints = Buffer.alloc(LENGTH * 10);
+a.writeTo(fixed);
+a.writeVarints(varints);
+add(`Integer.fromBuffer() loop x${LENGTH}`, () => {
+	let last;
+	for (let i = 0; i < LENGTH; ++i) last = Integer.fromBuffer(fixed, i * 8);
+	return last;
+});
+add(`Integer.Array.fromBuffer() x${LENGTH}`, () => Integer.Array.fromBuffer(fixed));
+add(`Integer.Array#writeVarints() x${LENGTH}`, () => a.writeVarints(varints));
+add(`Integer.Array.fromVarints() x${LENGTH}`, () => Integer.Array.fromVarints(varints, 0, LENGTH));
+
+// One value in ten is invalid, as in a dirty import.
+const dirty = values.map((value, i) => i % 10 ? String(value) : `${value}?`);
+const dirtyText = Buffer.from(dirty.join(','));
+add(`Integer.fromString() try/catch x${LENGTH}`, () => {
+	let last;
+	for (let i = 0; i < LENGTH; ++i) {
+		try { last = Integer.fromString(dirty[i]); } catch (_) {}
+	}
+	return last;
+});
+add(`Integer.tryFromString() x${LENGTH}`, () => {
+	let last;
+	for (let i = 0; i < LENGTH; ++i) last = Integer.tryFromString(dirty[i]);
+	return last;
+});
+add(`Integer.parseMany(array) x${LENGTH}`, () => Integer.parseMany(dirty));
+add(`Integer.parseMany(buffer) x${LENGTH}`, () => Integer.parseMany(dirtyText));
+
+module.exports = cases;
@@ -0,0 +1,20 @@
+'use strict';
+const Integer = require('../..');
+
+// Chained operations whose intermediate results are all newly created.
+const a = Integer('123456789');
+const b = Integer(987654);
+const c = Integer(31);
+
+// The same chain of operations as a compiled pipeline.
+const mask = Integer(0xffff);
+const hash = Integer.compile([['multiply', 2654435761], ['add', b], ['shiftRight', 3], ['and', mask]]);
+const values = Integer.Array.from(Array.from({ length: 10000 }, (_, i) => i * 7919));
+
+module.exports = [
+	{ name: 'a.add(b).multiply(c)', fn: () => a.add(b).multiply(c) },
+	{ name: 'a.add(b).multiply(c).subtract(a)', fn: () => a.add(b).multiply(c).subtract(a) },
+	{ name: 'a.multiply(k).add(b).shiftRight(3).and(mask)', fn: () => a.multiply(2654435761).add(b).shiftRight(3).and(mask) },
+	{ name: 'pipeline.apply(a)', fn: () => hash.apply(a) },
+	{ name: 'pipeline.applyAll() x10000', fn: () => hash.applyAll(values) },
+];
@@ -0,0 +1,112 @@
+'use strict';
+const Integer = require('../..');
+
+// Each binary method is timed once per kind of argument accepted by Cast().
+const receiver = Integer(123456789);
+const argumentKinds = [
+	['smi', 7],
+	['double', 4294967297],
+	['string', '1234567'],
+	['integer', Integer(1234567)],
+];
+
+const binaryMethods = [
+	'add', 'subtract', 'multiply', 'divide', 'modulo',
+	'and', 'or', 'xor',
+	'equals', 'notEquals', 'greaterThan', 'greaterThanOrEquals',
+	'lessThan', 'lessThanOrEquals', 'compare',
+];
+
+const unaryMethods = [
+	'negate', 'abs', 'not', 'bitSizeAbs',
+	'isEven', 'isOdd', 'isPositive', 'isNegative', 'isZero', 'isNonZero',
+	'isSafe', 'isUnsafe', 'hash', 'toNumberUnsafe', 'valueOf', 'toString',
+];
+
+const shiftMethods = ['shiftLeft', 'shiftRight'];
+const getters = ['low', 'high'];
+const radixes = [2, 10, 16];
+
+const cases = [];
+const add = (name, fn) => cases.push({ name, fn });
+
+for (const method of binaryMethods) {
+	for (const [kind, arg] of argumentKinds) {
+		add(`${method}(${kind})`, () => receiver[method](arg));
+	}
+}
+for (const method of unaryMethods) {
+	add(`${method}()`, () => receiver[method]());
+}
+for (const method of shiftMethods) {
+	add(`${method}(3)`, () => receiver[method](3));
+}
+for (const getter of getters) {
+	add(`.${getter}`, () => receiver[getter]);
+}
+
+for (const [kind, arg] of argumentKinds) {
+	add(`Integer(${kind})`, () => Integer(arg));
+}
+add('Integer.fromNumber(smi)', () => Integer.fromNumber(7));
+add('Integer.fromNumber(double)', () => Integer.fromNumber(4294967297));
+add('Integer.fromBits(low, high)', () => Integer.fromBits(-1, 0x7fffffff));
+add('Integer.isInstance(integer)', () => Integer.isInstance(receiver));
+add('Integer.isInstance(object)', () => Integer.isInstance(argumentKinds));
+
+// Direct BigInt conversions, compared to going through a decimal string.
+const bigint = 1234567890123456789n;
+const wideInteger = Integer(bigint);
+add('Integer.fromBigInt(bigint)', () => Integer.fromBigInt(bigint));
+add('Integer.fromString(String(bigint))', () => Integer.fromString(String(bigint)));
+add('add(bigint)', () => receiver.add(7n));
+add('toBigInt()', () => wideInteger.toBigInt());
+add('BigInt(toString())', () => BigInt(wideInteger.toString()));
+
+const wide = Integer.fromString('7fffffffffffffff', 16);
+for (const radix of radixes) {
+	const string = wide.toString(radix);
+	add(`Integer.fromString(radix ${radix})`, () => Integer.fromString(string, radix));
+	add(`toString(${radix})`, () => wide.toString(radix));
+}
+
+// Results within the range of shared instances, and results that leave the
+// receiver unchanged, do not need to allocate.
+const small = Integer(100);
+add('add(smi) small result', () => small.add(7));
+add('add(0)', () => receiver.add(0));
+add('multiply(1)', () => receiver.multiply(1));
+
+// Operations with 128-bit intermediates, compared to their 64-bit equivalents.
+const large = Integer('9000000000000000000');
+add('mulDiv(smi, smi)', () => large.mulDiv(3, 4));
+add('mulDiv(smi, smi, halfEven)', () => large.mulDiv(3, 4, 'halfEven'));
+add('mulMod(integer, smi)', () => large.mulMod(large, 1000000007));
+add('powMod(integer, smi)', () => receiver.powMod(large, 1000000007));
+add('gcd(integer)', () => large.gcd(receiver));
+add('sqrt()', () => large.sqrt());
+
+// Fixed-point decimals, compared to the same arithmetic on scaled Integers.
+const price = Integer.Decimal('1234.56');
+const rate = Integer.Decimal('0.075');
+const cents = Integer(123456);
+add('Decimal.fromString()', () => Integer.Decimal.fromString('1234.56'));
+add('Decimal#add(decimal)', () => price.add(rate));
+add('Decimal#multiply(decimal, halfEven)', () => price.multiply(rate, 2, 'halfEven'));
+add('Decimal#divide(smi)', () => price.divide(3));
+add('Decimal#toString()', () => price.toString());
+add('mulDiv(smi, smi) scaled', () => cents.mulDiv(75, 1000, 'halfEven'));
+
+const unsafe = Integer.MAX_VALUE;
+add('valueOf() throws', () => {
+	try { return unsafe.valueOf(); } catch (err) { return err; }
+});
+
+// Atomic updates of a shared counter, compared to the unchecked built-in.
+const shared = new Integer.SharedArray(1);
+const bigints = new BigInt64Array(shared.buffer);
+add('SharedArray#fetchAdd(smi)', () => shared.fetchAdd(0, 1));
+add('SharedArray#load()', () => shared.load(0));
+add('Atomics.add(BigInt64Array)', () => Atomics.add(bigints, 0, 1n));
+
+module.exports = cases;
@@ -1,4 +1,9 @@
 {
+  'variables': {
+    # Build with --integer_stats=true to count calls, allocations, casts, and
+    # errors (exposed as Integer.stats() and Integer.resetStats()).
+    'integer_stats%': 'false',
+  },
   'target_defaults': {
     'default_configuration': 'Release',
     'msvs_settings': {
@@ -63,6 +68,11 @@
           '-stdlib=libc++',
         ],
       },
+      'conditions': [
+        ['integer_stats=="true"', {
+          'defines': ['INTEGER_STATS'],
+        }],
+      ],
     }
   ],
 }
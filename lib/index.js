@@ -23,6 +23,7 @@ defineStatic('MIN_VALUE', Integer.fromBits(0, -0x80000000));
 defineStatic('ZERO', Integer.fromBits(0, 0));
 defineStatic('ONE', Integer.fromBits(1, 0));
 defineStatic('NEG_ONE', Integer.fromBits(-1, -1));
+defineStatic('compile', ops => new Integer.Pipeline(ops));
 
 alias('add', ['plus']);
 alias('subtract', ['minus', 'sub']);
@@ -0,0 +1,183 @@
+// A mutable 64-bit integer for aggregation loops, which (unlike a chain of
+// Integer operations) does not allocate anything per step. Its value is stored
+// just like an Integer's, followed by a field that holds its overflow mode.
+class Accumulator {
+public:
+
+	static v8::Local<v8::FunctionTemplate> Init(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, New, "Accumulator");
+		t->InstanceTemplate()->SetInternalFieldCount(MODE_FIELD + 1);
+		SetPrototypeMethod(isolate, data, t, "add", Add);
+		SetPrototypeMethod(isolate, data, t, "subtract", Subtract);
+		SetPrototypeMethod(isolate, data, t, "multiply", Multiply);
+		SetPrototypeMethod(isolate, data, t, "min", Min);
+		SetPrototypeMethod(isolate, data, t, "max", Max);
+		SetPrototypeMethod(isolate, data, t, "addAll", AddAll);
+		SetPrototypeMethod(isolate, data, t, "reset", Reset);
+		SetPrototypeMethod(isolate, data, t, "toInteger", ToInteger);
+		return t;
+	}
+
+private:
+
+	enum Mode { THROW, SATURATE, WRAP };
+
+	NODE_METHOD(New) {
+		if (!info.IsConstructCall()) return ThrowTypeError(info, "Class constructor Accumulator cannot be invoked without 'new'");
+		int64_t value = 0;
+		Mode mode = THROW;
+		if (info.Length() > 0 && !info[0]->IsUndefined()) {
+			Result cast = Cast(info, info[0]);
+			if (cast.error) return ThrowException(info, *cast.error);
+			value = cast.Checked();
+		}
+		if (info.Length() > 1 && !ParseMode(info, info[1], mode)) return;
+		Store(info.This(), value);
+		info.This()->SetAlignedPointerInInternalField(MODE_FIELD, reinterpret_cast<void*>((uintptr_t)mode << 1));
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(Add) { Step<AddOp>(info); }
+	NODE_METHOD(Subtract) { Step<SubtractOp>(info); }
+	NODE_METHOD(Multiply) { Step<MultiplyOp>(info); }
+
+	NODE_METHOD(Min) { UseValue; UseArgument;
+		if (arg < value) Store(info.This(), arg);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(Max) { UseValue; UseArgument;
+		if (arg > value) Store(info.This(), arg);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	// Adds every element of an array, BigInt64Array, or Integer.Array. In the
+	// throwing mode, the value is left unchanged if anything goes wrong.
+	NODE_METHOD(AddAll) { UseValue;
+		if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");
+		v8::Local<v8::Value> values = info[0];
+		v8::Local<v8::BigInt64Array> other;
+		if (values->IsBigInt64Array()) other = v8::Local<v8::BigInt64Array>::Cast(values);
+		else if (IntegerArray::HasInstance(values)) other = IntegerArray::Elements(v8::Local<v8::Object>::Cast(values));
+		Mode mode = GetMode(info.This());
+		if (!other.IsEmpty()) {
+			const int64_t* elements = Int64Data(other);
+			const size_t length = other->Length();
+			if (mode == THROW) {
+				size_t index = IntegerArray::Sum(elements, length, value);
+				if (index != length) return IntegerArray::ThrowAtIndex(info, Error::INTEGER_OVERFLOW, index);
+			} else if (mode == WRAP) {
+				for (size_t i = 0; i < length; ++i) value = WrappingAdd(value, elements[i]);
+			} else {
+				for (size_t i = 0; i < length; ++i) Apply<AddOp>(value, elements[i], mode, value);
+			}
+		} else if (values->IsArray()) {
+			v8::Local<v8::Context> ctx = info.GetIsolate()->GetCurrentContext();
+			v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(values);
+			for (uint32_t i = 0, length = array->Length(); i < length; ++i) {
+				v8::Local<v8::Value> element;
+				if (!array->Get(ctx, i).ToLocal(&element)) return;
+				Result cast = Cast(info, element);
+				if (cast.error) return ThrowException(info, *cast.error);
+				if (!Apply<AddOp>(value, cast.Checked(), mode, value)) {
+					return IntegerArray::ThrowAtIndex(info, Error::INTEGER_OVERFLOW, i);
+				}
+			}
+		} else {
+			return ThrowTypeError(info, "Expected an array, BigInt64Array, or Integer.Array");
+		}
+		Store(info.This(), value);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(Reset) {
+		int64_t value = 0;
+		if (info.Length() > 0) {
+			Result cast = Cast(info, info[0]);
+			if (cast.error) return ThrowException(info, *cast.error);
+			value = cast.Checked();
+		}
+		Store(info.This(), value);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(ToInteger) { UseValue;
+		Integer::ReturnNew(info, value);
+	}
+
+	// Each operation provides its overflow check (the same one used by Integer),
+	// its wrapped result, and the bound it saturates to when it overflows.
+	struct AddOp {
+		static inline bool Overflows(int64_t a, int64_t b) { return AddOverflows(a, b); }
+		static inline int64_t Wrap(int64_t a, int64_t b) { return WrappingAdd(a, b); }
+		static inline int64_t Bound(int64_t, int64_t b) { return b < 0 ? INT64_MIN : INT64_MAX; }
+	};
+	struct SubtractOp {
+		static inline bool Overflows(int64_t a, int64_t b) { return SubtractOverflows(a, b); }
+		static inline int64_t Wrap(int64_t a, int64_t b) { return WrappingSubtract(a, b); }
+		static inline int64_t Bound(int64_t, int64_t b) { return b < 0 ? INT64_MAX : INT64_MIN; }
+	};
+	struct MultiplyOp {
+		static inline bool Overflows(int64_t a, int64_t b) { return MultiplyOverflows(a, b); }
+		static inline int64_t Wrap(int64_t a, int64_t b) { return (int64_t)((uint64_t)a * (uint64_t)b); }
+		static inline int64_t Bound(int64_t a, int64_t b) { return (a < 0) != (b < 0) ? INT64_MIN : INT64_MAX; }
+	};
+
+	// Returns false if the operation overflowed in the throwing mode.
+	template <class Op>
+	static inline bool Apply(int64_t a, int64_t b, Mode mode, int64_t& result) {
+		if (!Op::Overflows(a, b)) {
+			result = Op::Wrap(a, b);
+		} else if (mode == WRAP) {
+			result = Op::Wrap(a, b);
+		} else if (mode == SATURATE) {
+			result = Op::Bound(a, b);
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+	template <class Op>
+	static void Step(NODE_ARGUMENTS info) { UseValue; UseArgument;
+		if (!Apply<Op>(value, arg, GetMode(info.This()), value)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		Store(info.This(), value);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	static bool ParseMode(NODE_ARGUMENTS info, v8::Local<v8::Value> options, Mode& mode) {
+		if (options->IsUndefined()) return true;
+		if (!options->IsObject()) {
+			ThrowTypeError(info, "Expected the options to be an object");
+			return false;
+		}
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Value> overflow;
+		if (!v8::Local<v8::Object>::Cast(options)->Get(isolate->GetCurrentContext(), InternalizedFromLatin1(isolate, "overflow")).ToLocal(&overflow)) return false;
+		if (overflow->IsUndefined() || overflow->StrictEquals(InternalizedFromLatin1(isolate, "throw"))) mode = THROW;
+		else if (overflow->StrictEquals(InternalizedFromLatin1(isolate, "saturate"))) mode = SATURATE;
+		else if (overflow->StrictEquals(InternalizedFromLatin1(isolate, "wrap"))) mode = WRAP;
+		else {
+			ThrowTypeError(info, "Expected the overflow option to be \"throw\", \"saturate\", or \"wrap\"");
+			return false;
+		}
+		return true;
+	}
+
+	static inline Mode GetMode(v8::Local<v8::Object> object) {
+		return (Mode)(reinterpret_cast<uintptr_t>(object->GetAlignedPointerFromInternalField(MODE_FIELD)) >> 1);
+	}
+
+	static inline void Store(v8::Local<v8::Object> object, int64_t value) {
+		SetInt64(object, TAGS, value);
+	}
+
+	static inline Result Cast(NODE_ARGUMENTS info, v8::Local<v8::Value> value) {
+		return Integer::Cast(info, value);
+	}
+
+	static const int MODE_FIELD = INT64_FIELD_COUNT;
+	static Int64Tag TAGS[2];
+};
+
+Int64Tag Accumulator::TAGS[2] = { { 0, false }, { 0, true } };
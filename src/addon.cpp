@@ -1,22 +1,92 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <vector>
 #include <node.h>
-#include <node_object_wrap.h>
+#include <uv.h>
+// Asynchronous cleanup hooks were added in Node 12.19 and 14.8.
+#if NODE_MAJOR_VERSION >= 15 || (NODE_MAJOR_VERSION == 14 && NODE_MINOR_VERSION >= 8) || (NODE_MAJOR_VERSION == 12 && NODE_MINOR_VERSION >= 19)
+#define INTEGER_ASYNC_CLEANUP
+#endif
 template <class T> using CopyablePersistent = v8::Persistent<T, v8::CopyablePersistentTraits<T>>;
 
+struct Addon;
+#include "stats.cpp"
+
 struct Addon {
 	CopyablePersistent<v8::Function> constructor;
-	CopyablePersistent<v8::FunctionTemplate> constructorTemplate;
-	struct { bool privileges; int64_t value; } controller;
+	CopyablePersistent<v8::Object> blank;
+	CopyablePersistent<v8::Object> decimalBlank;
+	CopyablePersistent<v8::Function> arrayConstructor;
+	std::vector<CopyablePersistent<v8::Object>> cache;
+	uint64_t hashSeed = 0;
+	uv_loop_t* loop = NULL;
+	size_t tasks = 0;
+	bool closed = false;
+#ifdef INTEGER_ASYNC_CLEANUP
+	node::AsyncCleanupHookHandle cleanupHook;
+	void (*cleanupDone)(void*) = NULL;
+	void* cleanupDoneArg = NULL;
+#endif
+#ifdef INTEGER_STATS
+	Stats stats;
+#endif
 
+	// The environment must not shut down while tasks are still running on the
+	// threadpool, since they use its memory. The cleanup hook is asynchronous,
+	// so Node keeps running the event loop until the last task finishes (and
+	// is discarded, see Batch::Task) and calls Close(). Older versions of Node
+	// cannot wait, so only the addon itself is kept alive for running tasks.
+#ifdef INTEGER_ASYNC_CLEANUP
+	static void Cleanup(void* ptr, void (*done)(void*), void* done_arg) {
+		Addon* addon = static_cast<Addon*>(ptr);
+		addon->cleanupDone = done;
+		addon->cleanupDoneArg = done_arg;
+		addon->closed = true;
+		if (!addon->tasks) addon->Close();
+	}
+#else
 	static void Cleanup(void* ptr) {
-		delete static_cast<Addon*>(ptr);
+		Addon* addon = static_cast<Addon*>(ptr);
+		addon->closed = true;
+		if (!addon->tasks) addon->Close();
+	}
+#endif
+
+	void Close() {
+#ifdef INTEGER_ASYNC_CLEANUP
+		void (*done)(void*) = cleanupDone;
+		void* done_arg = cleanupDoneArg;
+		delete this;
+		done(done_arg);
+#else
+		delete this;
+#endif
 	}
 };
 
 #include "result.cpp"
 #include "macros.cpp"
+#include "arithmetic.cpp"
+#include "digits.cpp"
+#include "binary.cpp"
+#include "sorting.cpp"
 #include "integer.cpp"
+#include "integer-array.cpp"
+#include "accumulator.cpp"
+#include "decimal.cpp"
+#include "pipeline.cpp"
+#include "shared-array.cpp"
+#include "batch.cpp"
+#include "hash-table.cpp"
 
 NODE_MODULE_INIT(/* exports, context */) {
 	v8::Isolate* isolate = context->GetIsolate();
@@ -24,20 +94,57 @@ NODE_MODULE_INIT(/* exports, context */) {
 
 	// Initialize addon instance.
 	Addon* addon = new Addon();
+	addon->loop = node::GetCurrentEventLoop(isolate);
+	addon->hashSeed = Integer::Mix(uv_hrtime() ^ (uint64_t)(uintptr_t)addon);
 	v8::Local<v8::External> data = v8::External::New(isolate, addon);
+#ifdef INTEGER_ASYNC_CLEANUP
+	addon->cleanupHook = node::AddEnvironmentCleanupHook(isolate, Addon::Cleanup, addon);
+#else
 	node::AddEnvironmentCleanupHook(isolate, Addon::Cleanup, addon);
+#endif
 
 	// Create constructor template and constructor.
 	v8::Local<v8::FunctionTemplate> t = Integer::Init(isolate, data);
-	t->PrototypeTemplate()->SetInternalFieldCount(1);
+	// Integer.parseMany() returns an Integer.Array, so it is defined there.
+	SetStaticMethod(isolate, data, t, "parseMany", IntegerArray::ParseMany);
+	SetStaticMethod(isolate, data, t, "parseManyAsync", Batch::ParseManyAsync);
 	v8::Local<v8::Function> c = t->GetFunction(context).ToLocalChecked();
-	v8::Local<v8::Object>::Cast(c->Get(context, InternalizedFromLatin1(isolate, "prototype")).ToLocalChecked())->SetAlignedPointerInInternalField(0, &addon->controller);
+
+	// Create the IntegerArray class, which is exposed as Integer.Array.
+	v8::Local<v8::FunctionTemplate> at = IntegerArray::Init(isolate, data);
+	Batch::Init(isolate, data, at);
+	v8::Local<v8::Function> ac = at->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "Array"), ac).FromJust();
+
+	// Create the Accumulator class, which is exposed as Integer.Accumulator.
+	v8::Local<v8::Function> acc = Accumulator::Init(isolate, data)->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "Accumulator"), acc).FromJust();
+
+	// Create the Decimal class, which is exposed as Integer.Decimal.
+	v8::Local<v8::FunctionTemplate> dt = Decimal::Init(isolate, data);
+	v8::Local<v8::Function> dc = dt->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "Decimal"), dc).FromJust();
+
+	// Create the Pipeline class, which is exposed as Integer.Pipeline.
+	v8::Local<v8::Function> pc = Pipeline::Init(isolate, data)->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "Pipeline"), pc).FromJust();
+
+	// Create the SharedArray class, which is exposed as Integer.SharedArray.
+	v8::Local<v8::Function> sc = SharedArray::Init(isolate, data)->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "SharedArray"), sc).FromJust();
+
+	// Create the hash tables, which are exposed as Integer.Map and Integer.Set.
+	v8::Local<v8::Function> mc = HashTable::InitMap(isolate, data)->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "Map"), mc).FromJust();
+	v8::Local<v8::Function> setc = HashTable::InitSet(isolate, data)->GetFunction(context).ToLocalChecked();
+	c->Set(context, InternalizedFromLatin1(isolate, "Set"), setc).FromJust();
 
 	// Store addon instance data.
 	addon->constructor.Reset(isolate, c);
-	addon->constructorTemplate.Reset(isolate, t);
-	addon->controller.privileges = false;
-	addon->controller.value = 0;
+	addon->blank.Reset(isolate, t->InstanceTemplate()->NewInstance(context).ToLocalChecked());
+	addon->decimalBlank.Reset(isolate, dt->InstanceTemplate()->NewInstance(context).ToLocalChecked());
+	addon->arrayConstructor.Reset(isolate, ac);
+	addon->cache.resize(size_t(Integer::CACHE_LENGTH));
 
 	// Export constructor.
 	exports->Set(context, InternalizedFromLatin1(isolate, "Integer"), c).FromJust();
@@ -0,0 +1,187 @@
+// Overflow checks shared by Integer and the bulk kernels. Each returns true
+// if the operation cannot be represented as a signed 64-bit integer.
+
+inline bool AddOverflows(int64_t a, int64_t b) {
+	return (b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b);
+}
+
+inline bool SubtractOverflows(int64_t a, int64_t b) {
+	return (b < 0 && a > INT64_MAX + b) || (b > 0 && a < INT64_MIN + b);
+}
+
+inline bool MultiplyOverflows(int64_t a, int64_t b) {
+	return a > 0
+		? (b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a)
+		: (b > 0 ? a < INT64_MIN / b : (a != 0 && b < INT64_MAX / a));
+}
+
+inline bool DivideOverflows(int64_t a, int64_t b) {
+	return b == -1 && a == INT64_MIN;
+}
+
+// Branch-free forms of the checks above, used by loops that vectorize.
+// Each returns a negative number if and only if the operation overflowed.
+inline int64_t AddOverflowBits(int64_t a, int64_t b, int64_t result) {
+	return (a ^ result) & (b ^ result);
+}
+
+inline int64_t SubtractOverflowBits(int64_t a, int64_t b, int64_t result) {
+	return (a ^ b) & (a ^ result);
+}
+
+// Multiplication has no vector form of its check, but this one still avoids
+// the divisions (and branches) of MultiplyOverflows().
+inline int64_t MultiplyOverflowBits(int64_t a, int64_t b) {
+#ifdef __SIZEOF_INT128__
+	__int128 product = (__int128)a * b;
+	return -(int64_t)(product != (int64_t)product);
+#else
+	return -(int64_t)MultiplyOverflows(a, b);
+#endif
+}
+
+inline int64_t WrappingAdd(int64_t a, int64_t b) {
+	return (int64_t)((uint64_t)a + (uint64_t)b);
+}
+
+inline int64_t WrappingSubtract(int64_t a, int64_t b) {
+	return (int64_t)((uint64_t)a - (uint64_t)b);
+}
+
+// Unsigned 128-bit intermediates, for operations whose final result fits in 64
+// bits even when an intermediate product does not. Compilers that have a
+// native 128-bit type use it, and others (such as MSVC) use 32-bit digits.
+struct Uint128 {
+	uint64_t high;
+	uint64_t low;
+};
+
+inline uint64_t Magnitude(int64_t value) {
+	return value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+}
+
+inline Uint128 MultiplyFull(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 product = (unsigned __int128)a * b;
+	Uint128 result = { (uint64_t)(product >> 64), (uint64_t)product };
+#else
+	uint64_t p0 = (a & 0xffffffff) * (b & 0xffffffff);
+	uint64_t p1 = (a & 0xffffffff) * (b >> 32);
+	uint64_t p2 = (a >> 32) * (b & 0xffffffff);
+	uint64_t p3 = (a >> 32) * (b >> 32);
+	uint64_t middle = (p0 >> 32) + (p1 & 0xffffffff) + (p2 & 0xffffffff);
+	Uint128 result = { p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32), (middle << 32) | (p0 & 0xffffffff) };
+#endif
+	return result;
+}
+
+// Divides by a non-zero divisor, which must be greater than the high half of
+// the dividend (so that the quotient fits in 64 bits). The fallback is the
+// normalized long division from Hacker's Delight (divlu), in 32-bit digits.
+inline uint64_t DivideFull(Uint128 n, uint64_t d, uint64_t& remainder) {
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 dividend = ((unsigned __int128)n.high << 64) | n.low;
+	remainder = (uint64_t)(dividend % d);
+	return (uint64_t)(dividend / d);
+#else
+	const uint64_t b = (uint64_t)1 << 32;
+	int s = 0;
+	while (!(d & ((uint64_t)1 << 63))) { d <<= 1; ++s; }
+	uint64_t vn1 = d >> 32;
+	uint64_t vn0 = d & 0xffffffff;
+	uint64_t un32 = s ? (n.high << s) | (n.low >> (64 - s)) : n.high;
+	uint64_t un10 = n.low << s;
+	uint64_t un1 = un10 >> 32;
+	uint64_t un0 = un10 & 0xffffffff;
+	uint64_t q1 = un32 / vn1;
+	uint64_t rhat = un32 - q1 * vn1;
+	while (q1 >= b || q1 * vn0 > b * rhat + un1) {
+		q1 -= 1;
+		rhat += vn1;
+		if (rhat >= b) break;
+	}
+	uint64_t un21 = un32 * b + un1 - q1 * d;
+	uint64_t q0 = un21 / vn1;
+	rhat = un21 - q0 * vn1;
+	while (q0 >= b || q0 * vn0 > b * rhat + un0) {
+		q0 -= 1;
+		rhat += vn1;
+		if (rhat >= b) break;
+	}
+	remainder = (un21 * b + un0 - q0 * d) >> s;
+	return q1 * b + q0;
+#endif
+}
+
+// Unlike DivideFull(), the high half of the dividend can be anything.
+inline uint64_t RemainderFull(Uint128 n, uint64_t d) {
+	Uint128 reduced = { n.high % d, n.low };
+	uint64_t remainder;
+	DivideFull(reduced, d, remainder);
+	return remainder;
+}
+
+// Divides a dividend of any size, so the quotient can have 128 bits too.
+inline uint64_t DivideWide(Uint128 n, uint64_t d, Uint128& quotient) {
+	Uint128 low = { n.high % d, n.low };
+	uint64_t remainder;
+	quotient.high = n.high / d;
+	quotient.low = DivideFull(low, d, remainder);
+	return remainder;
+}
+
+// Returns false (leaving the value unspecified) if the product does not fit.
+inline bool MultiplyWide(Uint128& n, uint64_t m) {
+	Uint128 low = MultiplyFull(n.low, m);
+	Uint128 high = MultiplyFull(n.high, m);
+	n.low = low.low;
+	n.high = low.high + high.low;
+	return !high.high && n.high >= high.low;
+}
+
+inline uint64_t SquareRoot(uint64_t x) {
+	// The estimate can be off by one in either direction, since a double has
+	// fewer bits than the input.
+	uint64_t root = (uint64_t)std::sqrt((double)x);
+	while (root > 0 && root > x / root) --root;
+	while (root + 1 <= x / (root + 1)) ++root;
+	return root;
+}
+
+inline uint64_t GreatestCommonDivisor(uint64_t a, uint64_t b) {
+	while (b) {
+		uint64_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+// The least common multiple of the magnitudes (which is never negative), or
+// false if it does not fit.
+inline bool LeastCommonMultiple(int64_t a, int64_t b, int64_t& result) {
+	result = 0;
+	if (a == 0 || b == 0) return true;
+	const uint64_t x = Magnitude(a);
+	const uint64_t y = Magnitude(b);
+	Uint128 product = MultiplyFull(x / GreatestCommonDivisor(x, y), y);
+	if (product.high || product.low > (uint64_t)INT64_MAX) return false;
+	result = (int64_t)product.low;
+	return true;
+}
+
+// Raises the base to a non-negative exponent, or returns false if the power
+// does not fit. Squaring the base can only overflow when the result would too,
+// since there is always a later step that multiplies the result by it.
+inline bool Power(int64_t base, int64_t exponent, int64_t& result) {
+	result = 1;
+	for (;;) {
+		if (exponent & 1) {
+			if (MultiplyOverflows(result, base)) return false;
+			result *= base;
+		}
+		if (!(exponent >>= 1)) return true;
+		if (MultiplyOverflows(base, base)) return false;
+		base *= base;
+	}
+}
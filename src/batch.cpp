@@ -0,0 +1,447 @@
+// Operations on whole arrays that run on the libuv threadpool and return a
+// Promise, so that large inputs never block the event loop. The input is used
+// in place (not copied), so it must not be modified until the promise settles,
+// just like a buffer given to fs.write(). Where V8 has backing stores, the task
+// keeps its memory alive even if the input is transferred or detached.
+// Reductions and parsing can be split into several parts, which run on the
+// threadpool concurrently.
+class Batch {
+public:
+
+	static void Init(v8::Isolate* isolate, v8::Local<v8::External> data, v8::Local<v8::FunctionTemplate> array) {
+		SetPrototypeMethod(isolate, data, array, "sumAsync", SumAsync);
+		SetPrototypeMethod(isolate, data, array, "minAsync", MinAsync);
+		SetPrototypeMethod(isolate, data, array, "maxAsync", MaxAsync);
+		SetPrototypeMethod(isolate, data, array, "sortAsync", SortAsync);
+		SetPrototypeMethod(isolate, data, array, "uniqueAsync", UniqueAsync);
+	}
+
+	// Exposed as Integer.parseManyAsync(buffer, [radix, [separator, [options]]]).
+	NODE_METHOD(ParseManyAsync) {
+		if (info.Length() == 0 || !info[0]->IsUint8Array()) return ThrowTypeError(info, "Expected first argument to be a Buffer or Uint8Array");
+		uint8_t radix;
+		uint8_t separator;
+		size_t concurrency;
+		if (!IntegerArray::ParseTextOptions(info, radix, separator) || !ParseConcurrency(info, 3, concurrency)) return;
+		v8::Local<v8::Uint8Array> buffer = v8::Local<v8::Uint8Array>::Cast(info[0]);
+		const uint8_t* data = static_cast<const uint8_t*>(BufferData(buffer->Buffer())) + buffer->ByteOffset();
+		size_t size = buffer->ByteLength();
+		size_t parts = Parts(size, concurrency, MIN_PART_BYTES);
+		Start(info, new ParseTask(info, data, size, radix, separator, parts), buffer, parts);
+	}
+
+private:
+
+	// A task runs in phases, each of which is split into parts that run on the
+	// threadpool concurrently. After every part of a phase has finished, Next()
+	// runs on the main thread, and may start another phase. Otherwise, the
+	// promise is settled with Output(), or rejected with the recorded error
+	// (which only phases with a single part may record).
+	class Task {
+	public:
+		explicit Task(NODE_ARGUMENTS info) :
+			isolate(info.GetIsolate()),
+			addon(GetAddon(info.Data())),
+			error(NULL),
+			error_index(NO_INDEX),
+			pending(0) {}
+		virtual ~Task() {}
+
+		virtual void Run(size_t part) = 0;
+		virtual bool Next() { return false; }
+		virtual v8::MaybeLocal<v8::Value> Output() = 0;
+
+		void Queue(size_t parts) {
+			requests.assign(parts, uv_work_t());
+			pending = parts;
+			for (uv_work_t& request : requests) {
+				request.data = this;
+				uv_queue_work(addon->loop, &request, Work, AfterWork);
+			}
+		}
+
+		v8::Isolate* const isolate;
+		Addon* const addon;
+		const char* error;
+		size_t error_index;
+		v8::Persistent<v8::Promise::Resolver> resolver;
+		v8::Persistent<v8::Context> context;
+		v8::Persistent<v8::Object> resource;
+		v8::Persistent<v8::Value> input;
+#if V8_MAJOR_VERSION >= 8
+		std::shared_ptr<v8::BackingStore> input_store;
+#endif
+		node::async_context async_context;
+
+	protected:
+		std::vector<uv_work_t> requests;
+
+	private:
+		static void Work(uv_work_t* request) {
+			Task* task = static_cast<Task*>(request->data);
+			task->Run((size_t)(request - task->requests.data()));
+		}
+
+		static void AfterWork(uv_work_t* request, int status) {
+			Task* task = static_cast<Task*>(request->data);
+			if (--task->pending == 0) task->Finish();
+		}
+
+		// If the environment is shutting down, the task is discarded without
+		// settling its promise or starting another phase.
+		void Finish() {
+			if (addon->closed) return Release();
+			v8::HandleScope scope(isolate);
+			v8::Local<v8::Context> ctx = v8::Local<v8::Context>::New(isolate, context);
+			v8::Context::Scope context_scope(ctx);
+			if (!error && Next()) return;
+			{
+				// Settling the promise within a callback scope runs its
+				// reactions right away, instead of whenever JS is next called.
+				node::CallbackScope callback_scope(isolate, v8::Local<v8::Object>::New(isolate, resource), async_context);
+				v8::Local<v8::Promise::Resolver> promise = v8::Local<v8::Promise::Resolver>::New(isolate, resolver);
+				v8::TryCatch try_catch(isolate);
+				v8::Local<v8::Value> value;
+				if (error) {
+					std::string message = error_index == NO_INDEX ? error : IntegerArray::MessageAtIndex(error, error_index);
+					promise->Reject(ctx, v8::Exception::RangeError(StringFromLatin1(isolate, message.c_str()))).FromMaybe(false);
+				} else if (Output().ToLocal(&value)) {
+					promise->Resolve(ctx, value).FromMaybe(false);
+				} else {
+					promise->Reject(ctx, try_catch.Exception()).FromMaybe(false);
+				}
+			}
+			node::EmitAsyncDestroy(isolate, async_context);
+			Release();
+		}
+
+		void Release() {
+			Addon* owner = addon;
+#ifndef INTEGER_ASYNC_CLEANUP
+			// Without an asynchronous cleanup hook, the environment (and its
+			// isolate) may already be gone, so the task's handles are abandoned.
+			if (owner->closed) {
+				if (!--owner->tasks) owner->Close();
+				return;
+			}
+#endif
+			resolver.Reset();
+			context.Reset();
+			resource.Reset();
+			input.Reset();
+			delete this;
+			if (!--owner->tasks && owner->closed) owner->Close();
+		}
+
+		size_t pending;
+	};
+
+	class ReduceTask : public Task {
+	public:
+		enum Kind { SUM, MIN, MAX };
+
+		ReduceTask(NODE_ARGUMENTS info, Kind _kind, const int64_t* _elements, size_t _length, size_t parts) : Task(info),
+			kind(_kind), elements(_elements), length(_length), results(parts), fallback(NO_INDEX), value(0) {}
+
+		void Run(size_t part) {
+			if (fallback != NO_INDEX) {
+				size_t index = IntegerArray::Sum(elements + fallback, length - fallback, value);
+				if (index != length - fallback) {
+					error = Error::INTEGER_OVERFLOW.message;
+					error_index = fallback + index;
+				}
+				return;
+			}
+			size_t start = Split(length, part, results.size());
+			size_t end = Split(length, part + 1, results.size());
+			Part& result = results[part];
+			if (kind == MIN) result.value = IntegerArray::Min(elements + start, end - start);
+			else if (kind == MAX) result.value = IntegerArray::Max(elements + start, end - start);
+			else SumPart(elements + start, end - start, result);
+		}
+
+		// Each part's sum is added to the running total, unless adding any of
+		// its prefixes could overflow. In that case, the rest of the elements
+		// are summed one at a time (in another phase) to find the first one
+		// that overflows, just like Integer.Array#sum() would.
+		bool Next() {
+			if (fallback != NO_INDEX) return false;
+			value = kind == MIN ? INT64_MAX : kind == MAX ? INT64_MIN : 0;
+			for (size_t part = 0; part < results.size(); ++part) {
+				const Part& result = results[part];
+				if (kind == MIN) value = std::min(value, result.value);
+				else if (kind == MAX) value = std::max(value, result.value);
+				else if (!result.exact || AddOverflows(value, result.low) || AddOverflows(value, result.high)) {
+					fallback = Split(length, part, results.size());
+					Queue(1);
+					return true;
+				} else {
+					value += result.value;
+				}
+			}
+			return false;
+		}
+
+		v8::MaybeLocal<v8::Value> Output() {
+			if (kind != SUM && length == 0) return v8::Undefined(isolate);
+			v8::Local<v8::Object> result;
+			if (!Integer::NewInstance(isolate, addon, value).ToLocal(&result)) return v8::MaybeLocal<v8::Value>();
+			return result;
+		}
+
+	private:
+		struct Part {
+			int64_t value;
+			int64_t low;
+			int64_t high;
+			bool exact;
+		};
+
+		// Sums the elements starting from zero, while keeping track of the
+		// lowest and highest prefix sums.
+		static void SumPart(const int64_t* a, size_t length, Part& result) {
+			int64_t sum = 0;
+			int64_t low = 0;
+			int64_t high = 0;
+			int64_t flags = 0;
+			for (size_t i = 0; i < length; ++i) {
+				int64_t r = WrappingAdd(sum, a[i]);
+				flags |= AddOverflowBits(sum, a[i], r);
+				sum = r;
+				low = std::min(low, sum);
+				high = std::max(high, sum);
+			}
+			result.value = sum;
+			result.low = low;
+			result.high = high;
+			result.exact = flags >= 0;
+		}
+
+		const Kind kind;
+		const int64_t* const elements;
+		const size_t length;
+		std::vector<Part> results;
+		size_t fallback;
+		int64_t value;
+	};
+
+	class SortTask : public Task {
+	public:
+		SortTask(NODE_ARGUMENTS info, const int64_t* _elements, v8::Local<v8::BigInt64Array> _output, size_t _length, bool _unique) : Task(info),
+			elements(_elements), out(Int64Data(_output)), length(_length), count(_length), unique(_unique) {
+			output.Reset(isolate, _output);
+		}
+		~SortTask() {
+			output.Reset();
+		}
+
+		void Run(size_t part) {
+			SortValues(elements, out, length, false);
+			if (unique) count = std::unique(out, out + length) - out;
+		}
+
+		// Only unique values are kept, at the start of the same buffer.
+		v8::MaybeLocal<v8::Value> Output() {
+			v8::Local<v8::BigInt64Array> array = v8::Local<v8::BigInt64Array>::New(isolate, output);
+			if (count != length) array = v8::BigInt64Array::New(array->Buffer(), 0, count);
+			v8::Local<v8::Object> result;
+			if (!IntegerArray::NewInstance(isolate, addon, array).ToLocal(&result)) return v8::MaybeLocal<v8::Value>();
+			return result;
+		}
+
+	private:
+		const int64_t* const elements;
+		int64_t* const out;
+		const size_t length;
+		size_t count;
+		const bool unique;
+		v8::Persistent<v8::BigInt64Array> output;
+	};
+
+	// Fields are counted, then parsed, and then summarized in the bitmap of
+	// valid values, with each phase split into the same parts. Each part owns
+	// the fields that start within its share of the bytes, so it only needs to
+	// find the first separator before its share to know where to begin.
+	class ParseTask : public Task {
+	public:
+		ParseTask(NODE_ARGUMENTS info, const uint8_t* _data, size_t _size, uint8_t _radix, uint8_t _separator, size_t parts) : Task(info),
+			data(_data), size(_size), radix(_radix), separator(_separator), offsets(parts + 1), phase(0), length(0) {}
+		~ParseTask() {
+			values_array.Reset();
+			valid_array.Reset();
+			errors_array.Reset();
+		}
+
+		void Run(size_t part) {
+			const size_t parts = requests.size();
+			if (phase == 2) {
+				size_t bytes = (length + 7) / 8;
+				for (size_t i = Split(bytes, part, parts), end = Split(bytes, part + 1, parts); i < end; ++i) {
+					uint8_t byte = 0;
+					for (size_t j = 0; j < 8 && i * 8 + j < length; ++j) byte |= (uint8_t)((errors[i * 8 + j] == 0) << j);
+					valid[i] = byte;
+				}
+				return;
+			}
+			const uint8_t* field = data + Boundary(part, parts);
+			const uint8_t* end = data + Boundary(part + 1, parts);
+			if (phase == 0) {
+				size_t fields = std::count(field, end, separator);
+				if (field != end && end[-1] != separator) ++fields;
+				offsets[part + 1] = fields;
+				return;
+			}
+			for (size_t i = offsets[part]; field < end; ++i) {
+				const uint8_t* field_end = static_cast<const uint8_t*>(memchr(field, separator, end - field));
+				if (!field_end) field_end = end;
+				Result result = IntegerArray::ParseField(field, (size_t)(field_end - field), radix);
+				if (result.error) errors[i] = result.error->code;
+				else values[i] = result.Checked();
+				field = field_end + 1;
+			}
+		}
+
+		bool Next() {
+			if (phase == 0) {
+				for (size_t part = 1; part < offsets.size(); ++part) offsets[part] += offsets[part - 1];
+				length = offsets.back();
+				v8::Local<v8::BigInt64Array> values_local;
+				v8::Local<v8::Uint8Array> valid_local;
+				v8::Local<v8::Uint8Array> errors_local;
+				if (!NewTypedArray<v8::BigInt64Array, int64_t>(isolate, length, values_local)
+					|| !NewTypedArray<v8::Uint8Array, uint8_t>(isolate, (length + 7) / 8, valid_local)
+					|| !NewTypedArray<v8::Uint8Array, uint8_t>(isolate, length, errors_local)) {
+					error = "Array buffer allocation failed";
+					return false;
+				}
+				values = Int64Data(values_local);
+				valid = static_cast<uint8_t*>(BufferData(valid_local->Buffer()));
+				errors = static_cast<uint8_t*>(BufferData(errors_local->Buffer()));
+				values_array.Reset(isolate, values_local);
+				valid_array.Reset(isolate, valid_local);
+				errors_array.Reset(isolate, errors_local);
+			}
+			if (phase == 2) return false;
+			++phase;
+			Queue(requests.size());
+			return true;
+		}
+
+		v8::MaybeLocal<v8::Value> Output() {
+			v8::Local<v8::Object> result;
+			if (!IntegerArray::ParsedResult(
+				isolate,
+				addon,
+				v8::Local<v8::BigInt64Array>::New(isolate, values_array),
+				v8::Local<v8::Uint8Array>::New(isolate, valid_array),
+				v8::Local<v8::Uint8Array>::New(isolate, errors_array)
+			).ToLocal(&result)) return v8::MaybeLocal<v8::Value>();
+			return result;
+		}
+
+	private:
+		// Returns the start of the first field that starts within the given
+		// part's share of the bytes (or the end of that share).
+		size_t Boundary(size_t part, size_t parts) const {
+			size_t at = Split(size, part, parts);
+			if (at == 0 || at == size) return at;
+			const void* found = memchr(data + at - 1, separator, size - at + 1);
+			return found ? (size_t)(static_cast<const uint8_t*>(found) - data) + 1 : size;
+		}
+
+		const uint8_t* const data;
+		const size_t size;
+		const uint8_t radix;
+		const uint8_t separator;
+		std::vector<size_t> offsets;
+		int phase;
+		size_t length;
+		int64_t* values;
+		uint8_t* valid;
+		uint8_t* errors;
+		v8::Persistent<v8::BigInt64Array> values_array;
+		v8::Persistent<v8::Uint8Array> valid_array;
+		v8::Persistent<v8::Uint8Array> errors_array;
+	};
+
+	NODE_METHOD(SumAsync) { Reduce(info, ReduceTask::SUM); }
+	NODE_METHOD(MinAsync) { Reduce(info, ReduceTask::MIN); }
+	NODE_METHOD(MaxAsync) { Reduce(info, ReduceTask::MAX); }
+	NODE_METHOD(SortAsync) { Sort(info, false); }
+	NODE_METHOD(UniqueAsync) { Sort(info, true); }
+
+	static void Reduce(NODE_ARGUMENTS info, ReduceTask::Kind kind) {
+		size_t concurrency;
+		if (!ParseConcurrency(info, 0, concurrency)) return;
+		UseElements;
+		size_t parts = Parts(length, concurrency, MIN_PART_LENGTH);
+		Start(info, new ReduceTask(info, kind, elements, length, parts), array, parts);
+	}
+
+	static void Sort(NODE_ARGUMENTS info, bool unique) { UseElements;
+		v8::Local<v8::BigInt64Array> output;
+		if (!IntegerArray::Allocate(info, length, output)) return;
+		Start(info, new SortTask(info, elements, output, length, unique), array, 1);
+	}
+
+	// No JS code may run between reading the task's data and calling Start(),
+	// which pins the backing store that the data belongs to.
+	static void Start(NODE_ARGUMENTS info, Task* task, v8::Local<v8::ArrayBufferView> input, size_t parts) {
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		v8::Local<v8::Promise::Resolver> resolver;
+		if (!v8::Promise::Resolver::New(ctx).ToLocal(&resolver)) {
+			delete task;
+			return;
+		}
+		v8::Local<v8::Object> resource = v8::Object::New(isolate);
+		task->resolver.Reset(isolate, resolver);
+		task->context.Reset(isolate, ctx);
+		task->resource.Reset(isolate, resource);
+		task->input.Reset(isolate, input);
+#if V8_MAJOR_VERSION >= 8
+		task->input_store = input->Buffer()->GetBackingStore();
+#endif
+		task->async_context = node::EmitAsyncInit(isolate, resource, "Integer.Batch");
+		++task->addon->tasks;
+		task->Queue(parts);
+		info.GetReturnValue().Set(resolver->GetPromise());
+	}
+
+	static bool ParseConcurrency(NODE_ARGUMENTS info, int at, size_t& concurrency) {
+		concurrency = 1;
+		if (info.Length() <= at || info[at]->IsUndefined()) return true;
+		if (!info[at]->IsObject()) {
+			ThrowTypeError(info, "Expected the options to be an object");
+			return false;
+		}
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Value> value;
+		if (!v8::Local<v8::Object>::Cast(info[at])->Get(isolate->GetCurrentContext(), InternalizedFromLatin1(isolate, "concurrency")).ToLocal(&value)) return false;
+		if (value->IsUndefined()) return true;
+		if (!value->IsUint32()) {
+			ThrowTypeError(info, "Expected the concurrency to be a regular 32-bit unsigned integer");
+			return false;
+		}
+		concurrency = v8::Local<v8::Uint32>::Cast(value)->Value();
+		if (concurrency < 1 || concurrency > MAX_CONCURRENCY) {
+			ThrowRangeError(info, "The concurrency must be within 1 - 64");
+			return false;
+		}
+		return true;
+	}
+
+	// Small inputs are not worth splitting into as many parts as requested.
+	static inline size_t Parts(size_t length, size_t concurrency, size_t min_part) {
+		return std::max((size_t)1, std::min(concurrency, length / min_part));
+	}
+
+	static inline size_t Split(size_t length, size_t part, size_t parts) {
+		return (size_t)((uint64_t)length * part / parts);
+	}
+
+	static const size_t NO_INDEX = SIZE_MAX;
+	static const size_t MAX_CONCURRENCY = 64;
+	static const size_t MIN_PART_LENGTH = 65536;
+	static const size_t MIN_PART_BYTES = 1048576;
+};
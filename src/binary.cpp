@@ -0,0 +1,150 @@
+// Helpers for the binary encodings of 64-bit integers: fixed-width (in either
+// byte order), and base-128 varints as used by Protocol Buffers, where signed
+// values can be zigzag-encoded so that small negative numbers stay short.
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static const bool NATIVE_BIG_ENDIAN = true;
+#else
+static const bool NATIVE_BIG_ENDIAN = false;
+#endif
+
+static const size_t FIXED_LENGTH = 8;
+static const size_t MAX_VARINT_LENGTH = 10;
+
+inline uint64_t ByteSwap(uint64_t value) {
+#ifdef _MSC_VER
+	return _byteswap_uint64(value);
+#else
+	return __builtin_bswap64(value);
+#endif
+}
+
+inline uint64_t DecodeFixed(const uint8_t* data, bool big_endian) {
+	uint64_t value;
+	memcpy(&value, data, FIXED_LENGTH);
+	return big_endian == NATIVE_BIG_ENDIAN ? value : ByteSwap(value);
+}
+
+inline void EncodeFixed(uint8_t* data, uint64_t value, bool big_endian) {
+	if (big_endian != NATIVE_BIG_ENDIAN) value = ByteSwap(value);
+	memcpy(data, &value, FIXED_LENGTH);
+}
+
+inline uint64_t ZigZagEncode(int64_t value) {
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t value) {
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+inline size_t VarintSize(uint64_t value) {
+	size_t length = 1;
+	for (; value >= 0x80; value >>= 7) { ++length; }
+	return length;
+}
+
+inline uint8_t* EncodeVarint(uint8_t* data, uint64_t value) {
+	for (; value >= 0x80; value >>= 7) { *data++ = (uint8_t)value | 0x80; }
+	*data++ = (uint8_t)value;
+	return data;
+}
+
+// Returns the number of bytes read, or 0 if the varint does not end within the
+// available bytes, or does not fit in 64 bits.
+inline size_t DecodeVarint(const uint8_t* data, size_t available, uint64_t& value) {
+	size_t limit = std::min(available, MAX_VARINT_LENGTH);
+	uint64_t result = 0;
+	for (size_t i = 0; i < limit; ++i) {
+		uint8_t byte = data[i];
+		result |= (uint64_t)(byte & 0x7f) << (7 * i);
+		if (!(byte & 0x80)) {
+			if (i == MAX_VARINT_LENGTH - 1 && byte > 1) return 0;
+			value = result;
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+// Tells the two reasons DecodeVarint can fail apart, so that stream parsers can
+// wait for more data in one case and reject the input in the other.
+inline const char* VarintError(const uint8_t* data, size_t available) {
+	size_t limit = std::min(available, MAX_VARINT_LENGTH);
+	for (size_t i = 0; i < limit; ++i) {
+		if (!(data[i] & 0x80)) return "Malformed varint";
+	}
+	return limit == MAX_VARINT_LENGTH ? "Malformed varint" : "Truncated varint";
+}
+
+// Decodes up to count varints, returning the number of bytes read. Values
+// below 128 are the common case (e.g., lengths, tags, and zigzag-encoded small
+// numbers), so runs of eight of them are detected and unpacked in one step.
+inline size_t DecodeVarints(const uint8_t* data, size_t available, uint64_t* out, size_t count, size_t& decoded) {
+	size_t read = 0;
+	size_t i = 0;
+	while (i < count) {
+		if (count - i >= 8 && available - read >= 8) {
+			uint64_t chunk = LoadChunk(data + read);
+			if (!(chunk & 0x8080808080808080)) {
+				for (int j = 0; j < 8; ++j) out[i + j] = (chunk >> (8 * j)) & 0xff;
+				read += 8;
+				i += 8;
+				continue;
+			}
+		}
+		size_t length = DecodeVarint(data + read, available - read, out[i]);
+		if (length == 0) break;
+		read += length;
+		i += 1;
+	}
+	decoded = i;
+	return read;
+}
+
+// Counts the varints that end within the given bytes.
+inline size_t CountVarints(const uint8_t* data, size_t length) {
+	size_t count = 0;
+	for (size_t i = 0; i < length; ++i) count += !(data[i] & 0x80);
+	return count;
+}
+
+struct BinaryOptions {
+	bool big_endian;
+	bool zigzag;
+};
+
+// Reads an optional { endian, zigzag } object. Property getters can run
+// arbitrary JS, so this must happen before any buffer data is accessed.
+bool ParseBinaryOptions(NODE_ARGUMENTS info, int at, BinaryOptions& options) {
+	options.big_endian = false;
+	options.zigzag = false;
+	if (info.Length() <= at || info[at]->IsUndefined()) return true;
+	if (!info[at]->IsObject()) {
+		ThrowTypeError(info, "Expected the options to be an object");
+		return false;
+	}
+	v8::Isolate* isolate = info.GetIsolate();
+	v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+	v8::Local<v8::Object> object = v8::Local<v8::Object>::Cast(info[at]);
+	v8::Local<v8::Value> endian;
+	v8::Local<v8::Value> zigzag;
+	if (!object->Get(ctx, InternalizedFromLatin1(isolate, "endian")).ToLocal(&endian)) return false;
+	if (!object->Get(ctx, InternalizedFromLatin1(isolate, "zigzag")).ToLocal(&zigzag)) return false;
+	if (!endian->IsUndefined()) {
+		if (endian->StrictEquals(InternalizedFromLatin1(isolate, "big"))) {
+			options.big_endian = true;
+		} else if (!endian->StrictEquals(InternalizedFromLatin1(isolate, "little"))) {
+			ThrowTypeError(info, "Expected the endian option to be \"little\" or \"big\"");
+			return false;
+		}
+	}
+	if (!zigzag->IsUndefined()) {
+		if (!zigzag->IsBoolean()) {
+			ThrowTypeError(info, "Expected the zigzag option to be a boolean");
+			return false;
+		}
+		options.zigzag = zigzag->IsTrue();
+	}
+	return true;
+}
@@ -0,0 +1,430 @@
+// A fixed-point decimal number, made of an Integer mantissa and a scale (the
+// number of decimal places, up to 18). The scale is encoded in the tag, so a
+// Decimal has the same internal fields as an Integer, and it shares Integer's
+// overflow checks, rounding modes, and digit conversions. Products and
+// quotients are computed exactly in 128 bits before they are rounded.
+class Decimal {
+public:
+
+	static v8::Local<v8::FunctionTemplate> Init(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, New, "Decimal");
+		t->InstanceTemplate()->SetInternalFieldCount(INT64_FIELD_COUNT);
+		SetPrototypeGetter(isolate, data, t, "mantissa", Mantissa);
+		SetPrototypeGetter(isolate, data, t, "scale", Scale);
+		SetPrototypeMethod(isolate, data, t, "add", Add);
+		SetPrototypeMethod(isolate, data, t, "subtract", Subtract);
+		SetPrototypeMethod(isolate, data, t, "multiply", Multiply);
+		SetPrototypeMethod(isolate, data, t, "divide", Divide);
+		SetPrototypeMethod(isolate, data, t, "rescale", Rescale);
+		SetPrototypeMethod(isolate, data, t, "negate", Negate);
+		SetPrototypeMethod(isolate, data, t, "abs", Abs);
+		SetPrototypeMethod(isolate, data, t, "equals", Equals);
+		SetPrototypeMethod(isolate, data, t, "lessThan", LessThan);
+		SetPrototypeMethod(isolate, data, t, "greaterThan", GreaterThan);
+		SetPrototypeMethod(isolate, data, t, "compare", Compare);
+		SetPrototypeMethod(isolate, data, t, "isZero", IsZero);
+		SetPrototypeMethod(isolate, data, t, "isNegative", IsNegative);
+		SetPrototypeMethod(isolate, data, t, "isPositive", IsPositive);
+		SetPrototypeMethod(isolate, data, t, "toString", ToString);
+		SetPrototypeMethod(isolate, data, t, "toNumber", ToNumber);
+		SetStaticMethod(isolate, data, t, "fromString", FromString);
+		SetStaticMethod(isolate, data, t, "fromMantissa", FromMantissa);
+		SetStaticMethod(isolate, data, t, "isInstance", IsInstance);
+		return t;
+	}
+
+	static inline bool HasInstance(v8::Local<v8::Value> value) {
+		if (!value->IsObject()) return false;
+		v8::Local<v8::Object> object = v8::Local<v8::Object>::Cast(value);
+		if (object->InternalFieldCount() != INT64_FIELD_COUNT) return false;
+		uintptr_t tag = reinterpret_cast<uintptr_t>(GetTagFromInternalField(object, 0));
+		return tag - reinterpret_cast<uintptr_t>(TAGS) < sizeof(TAGS);
+	}
+
+private:
+
+	typedef Integer::Rounding Rounding;
+
+	// Decimal(value, [scale, [rounding]])
+	NODE_METHOD(New) {
+		if (info.IsConstructCall()) {
+			return ThrowTypeError(info, "Disabled constructor (use fromString or fromMantissa)");
+		}
+		int64_t mantissa = 0;
+		int scale = 0;
+		if (info.Length() > 0 && !CastOperand(info, info[0], mantissa, scale)) return;
+		if (info.Length() > 1 && !info[1]->IsUndefined()) {
+			int target;
+			Rounding rounding;
+			if (!ParseScale(info, 1, target) || !Integer::ParseRounding(info, 2, rounding)) return;
+			if (!Convert(mantissa, scale, target, rounding, mantissa)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+			scale = target;
+		}
+		if (HasInstance(info[0]) && GetScale(v8::Local<v8::Object>::Cast(info[0])) == scale) {
+			return info.GetReturnValue().Set(info[0]);
+		}
+		ReturnNew(info, mantissa, scale);
+	}
+
+	// fromString(string, [scale, [rounding]])
+	NODE_METHOD(FromString) {
+		v8::Local<v8::String> string;
+		REQUIRE_ARGUMENT_STRING(first, string);
+		int scale = NO_SCALE;
+		Rounding rounding;
+		if (!ParseScale(info, 1, scale) || !Integer::ParseRounding(info, 2, rounding)) return;
+		Result cast = Cast(info, string, scale, rounding);
+		if (cast.error) return ThrowException(info, *cast.error);
+		ReturnNew(info, cast.Checked(), scale);
+	}
+
+	// fromMantissa(mantissa, scale)
+	NODE_METHOD(FromMantissa) {
+		int64_t mantissa;
+		int scale = NO_SCALE;
+		if (!Integer::UseArgumentAt(info, 0, mantissa) || !ParseScale(info, 1, scale)) return;
+		if (scale == NO_SCALE) return ThrowTypeError(info, "Missing argument");
+		ReturnNew(info, mantissa, scale);
+	}
+
+	NODE_METHOD(IsInstance) {
+		info.GetReturnValue().Set(info.Length() != 0 && HasInstance(info[0]));
+	}
+
+	NODE_GETTER(Mantissa) { UseAddon;
+		int64_t mantissa = GetInt64(info.This());
+		info.GetReturnValue().Set(Integer::NewInstance(info.GetIsolate(), addon, mantissa).ToLocalChecked());
+	}
+
+	NODE_GETTER(Scale) {
+		info.GetReturnValue().Set(GetScale(info.This()));
+	}
+
+	NODE_METHOD(Add) { Sum<false>(info); }
+	NODE_METHOD(Subtract) { Sum<true>(info); }
+
+	// Both operands are converted to the larger of their scales, which is exact.
+	template <bool Subtracts>
+	static void Sum(NODE_ARGUMENTS info) { UseDecimal; UseDecimalArgument;
+		const int scale = std::max(value_scale, arg_scale);
+		int64_t a, b;
+		if (!Upscale(value, scale - value_scale, a) || !Upscale(arg, scale - arg_scale, b)
+			|| (Subtracts ? SubtractOverflows(a, b) : AddOverflows(a, b))) {
+			return ThrowException(info, Error::INTEGER_OVERFLOW);
+		}
+		ReturnResult(info, value, value_scale, Subtracts ? a - b : a + b, scale);
+	}
+
+	// multiply(other, [scale, [rounding]]), where the scale defaults to the
+	// larger of the operands' scales.
+	NODE_METHOD(Multiply) { UseDecimal; UseDecimalArgument;
+		int scale = std::max(value_scale, arg_scale);
+		Rounding rounding;
+		if (!ParseScale(info, 1, scale) || !Integer::ParseRounding(info, 2, rounding)) return;
+		const bool is_negative = (value < 0) != (arg < 0);
+		const int exact_scale = value_scale + arg_scale;
+		Uint128 product = MultiplyFull(Magnitude(value), Magnitude(arg));
+		int64_t result;
+		if (scale >= exact_scale) {
+			if (!MultiplyWide(product, POWERS_OF_TEN[scale - exact_scale]) || !DivideByPowerOfTen(product, 0, is_negative, rounding, result)) {
+				return ThrowException(info, Error::INTEGER_OVERFLOW);
+			}
+		} else if (!DivideByPowerOfTen(product, exact_scale - scale, is_negative, rounding, result)) {
+			return ThrowException(info, Error::INTEGER_OVERFLOW);
+		}
+		ReturnResult(info, value, value_scale, result, scale);
+	}
+
+	// divide(other, [scale, [rounding]]), where the scale defaults to the
+	// larger of the operands' scales. The dividend is scaled up (or the divisor,
+	// if the result has fewer decimal places) so that one division is enough.
+	NODE_METHOD(Divide) { UseDecimal; UseDecimalArgument;
+		int scale = std::max(value_scale, arg_scale);
+		Rounding rounding;
+		if (!ParseScale(info, 1, scale) || !Integer::ParseRounding(info, 2, rounding)) return;
+		if (arg == 0) return ThrowException(info, Error::DIVIDE_BY_ZERO);
+		const bool is_negative = (value < 0) != (arg < 0);
+		int shift = scale + arg_scale - value_scale;
+		Uint128 n = { 0, Magnitude(value) };
+		uint64_t d = Magnitude(arg);
+		int64_t result;
+		if (shift >= 0) {
+			if (shift > MAX_SCALE) {
+				MultiplyWide(n, POWERS_OF_TEN[MAX_SCALE]);
+				shift -= MAX_SCALE;
+			}
+			if (!MultiplyWide(n, POWERS_OF_TEN[shift]) || !Integer::DivideRounded(n, d, is_negative, rounding, result)) {
+				return ThrowException(info, Error::INTEGER_OVERFLOW);
+			}
+		} else {
+			Uint128 divisor = MultiplyFull(d, POWERS_OF_TEN[-shift]);
+			if (divisor.high) {
+				// The divisor is larger than any mantissa, so the quotient is zero
+				// and the remainder (if any) is less than half of it.
+				Uint128 zero = { 0, 0 };
+				Integer::DivideRounded(zero, 2, is_negative, rounding, result, value != 0);
+			} else if (!Integer::DivideRounded(n, divisor.low, is_negative, rounding, result)) {
+				return ThrowException(info, Error::INTEGER_OVERFLOW);
+			}
+		}
+		ReturnResult(info, value, value_scale, result, scale);
+	}
+
+	// rescale(scale, [rounding])
+	NODE_METHOD(Rescale) { UseDecimal;
+		int scale = NO_SCALE;
+		Rounding rounding;
+		if (!ParseScale(info, 0, scale) || !Integer::ParseRounding(info, 1, rounding)) return;
+		if (scale == NO_SCALE) return ThrowTypeError(info, "Missing argument");
+		int64_t result;
+		if (!Convert(value, value_scale, scale, rounding, result)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value_scale, result, scale);
+	}
+
+	NODE_METHOD(Negate) { UseDecimal;
+		if (value == Integer::MIN_VALUE) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value_scale, -value, value_scale);
+	}
+
+	NODE_METHOD(Abs) { UseDecimal;
+		if (value == Integer::MIN_VALUE) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value_scale, value < 0 ? -value : value, value_scale);
+	}
+
+	// Decimals are compared by value, so 1.5 equals 1.50.
+	NODE_METHOD(Equals) { UseDecimal; UseDecimalArgument;
+		info.GetReturnValue().Set(CompareValues(value, value_scale, arg, arg_scale) == 0);
+	}
+	NODE_METHOD(LessThan) { UseDecimal; UseDecimalArgument;
+		info.GetReturnValue().Set(CompareValues(value, value_scale, arg, arg_scale) < 0);
+	}
+	NODE_METHOD(GreaterThan) { UseDecimal; UseDecimalArgument;
+		info.GetReturnValue().Set(CompareValues(value, value_scale, arg, arg_scale) > 0);
+	}
+	NODE_METHOD(Compare) { UseDecimal; UseDecimalArgument;
+		info.GetReturnValue().Set(CompareValues(value, value_scale, arg, arg_scale));
+	}
+
+	NODE_METHOD(IsZero) { info.GetReturnValue().Set(GetInt64(info.This()) == 0); }
+	NODE_METHOD(IsNegative) { info.GetReturnValue().Set(GetInt64(info.This()) < 0); }
+	NODE_METHOD(IsPositive) { info.GetReturnValue().Set(GetInt64(info.This()) > 0); }
+
+	// Every decimal place of the scale is written, so 1.50 stays "1.50".
+	NODE_METHOD(ToString) { UseDecimal;
+		char buffer[STRING_BUFFER_LENGTH];
+		char* end = buffer + STRING_BUFFER_LENGTH;
+		char* string = WriteString(end, value, value_scale);
+		info.GetReturnValue().Set(StringFromLatin1(info.GetIsolate(), string, (int)(end - string)));
+	}
+
+	// The result is correctly rounded if the mantissa is a safe integer (since
+	// both it and the power of ten are then exact doubles).
+	NODE_METHOD(ToNumber) { UseDecimal;
+		info.GetReturnValue().Set((double)value / (double)POWERS_OF_TEN[value_scale]);
+	}
+
+	// Decimals keep their scale, strings have as many decimal places as they
+	// are written with, and anything else accepted by Integer has a scale of 0.
+	static bool CastOperand(NODE_ARGUMENTS info, v8::Local<v8::Value> value, int64_t& mantissa, int& scale) {
+		if (HasInstance(value)) {
+			v8::Local<v8::Object> object = v8::Local<v8::Object>::Cast(value);
+			mantissa = GetInt64(object);
+			scale = GetScale(object);
+			return true;
+		}
+		const bool is_string = value->IsString();
+		scale = is_string ? NO_SCALE : 0;
+		Result cast = is_string ? Cast(info, v8::Local<v8::String>::Cast(value), scale, Integer::TRUNC) : Integer::Cast(info, value);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		mantissa = cast.Checked();
+		return true;
+	}
+
+	// Strings that are short enough to be numbers are copied onto the stack, as
+	// in Integer::Cast().
+	static Result Cast(NODE_ARGUMENTS info, v8::Local<v8::String> string, int& scale, Rounding rounding) {
+		int length = string->Length();
+		if (length <= Integer::STRING_STACK_LENGTH) {
+			if (string->IsOneByte()) {
+				uint8_t buffer[Integer::STRING_STACK_LENGTH];
+				string->WriteOneByte(info.GetIsolate(), buffer, 0, length, v8::String::NO_NULL_TERMINATION);
+				return Parse(buffer, length, scale, rounding);
+			}
+			uint16_t buffer[Integer::STRING_STACK_LENGTH];
+			string->Write(info.GetIsolate(), buffer, 0, length, v8::String::NO_NULL_TERMINATION);
+			return Parse(buffer, length, scale, rounding);
+		}
+		v8::String::Value utf16(info.GetIsolate(), string);
+		return Parse(*utf16, utf16.length(), scale, rounding);
+	}
+
+	// Parses an optional minus sign followed by digits, optionally with a
+	// decimal point between them. Without a scale, it is set to the number of
+	// digits after the point. Otherwise, the mantissa is padded with zeros or
+	// rounded to the scale, using the first dropped digit and whether any of
+	// the others are non-zero.
+	template <typename Char>
+	static Result Parse(const Char* str, int len, int& scale, Rounding rounding) {
+		auto IsWhitespace = [](uint16_t c) { return c == ' ' || (c <= '\r' && c >= '\t'); };
+		int i = 0;
+
+		// Skip leading whitespace.
+		while (i<len && IsWhitespace(str[i])) { ++i; }
+		if (i == len) return Result(Error::NO_NUMBER);
+
+		bool is_negative = str[i] == '-';
+		uint64_t value = 0;
+		int integer_digits = 0;
+		int places = 0;
+		int dropped = 0;
+		unsigned first_dropped = 0;
+		bool sticky = false;
+		bool point = false;
+		for (i+=is_negative; i<len; ++i) {
+			unsigned digit = str[i] - '0';
+			if (digit > 9) {
+				if (str[i] != '.' || point) break;
+				point = true;
+				continue;
+			}
+			if (!point) {
+				++integer_digits;
+			} else if (places == (scale == NO_SCALE ? MAX_SCALE : scale)) {
+				if (scale == NO_SCALE) return Result(Error::TOO_PRECISE);
+				if (dropped++ == 0) first_dropped = digit;
+				else sticky |= digit != 0;
+				continue;
+			} else {
+				++places;
+			}
+			if (value > (UINT64_MAX - digit) / 10) return Result(Error::TOO_LARGE);
+			value = value * 10 + digit;
+		}
+
+		// Skip trailing whitespace.
+		while (i<len && IsWhitespace(str[i])) { ++i; }
+
+		if (i != len) return Result(Error::INVALID_DECIMAL);
+		if (!integer_digits && !places && !dropped) return Result(point ? Error::INVALID_DECIMAL : Error::NO_NUMBER);
+		if (!integer_digits || (point && !places && !dropped)) return Result(Error::INVALID_DECIMAL);
+
+		if (scale == NO_SCALE) {
+			scale = places;
+		} else if (places < scale) {
+			Uint128 padded = MultiplyFull(value, POWERS_OF_TEN[scale - places]);
+			if (padded.high) return Result(Error::TOO_LARGE);
+			value = padded.low;
+		} else if ((first_dropped || sticky) && Integer::RoundsAway(rounding, is_negative, value, first_dropped * 2 + sticky, 20)) {
+			if (value == UINT64_MAX) return Result(Error::TOO_LARGE);
+			++value;
+		}
+		if (value > Integer::I64_in_U64 + is_negative) return Result(Error::TOO_LARGE);
+		return Result((is_negative && value) ? -((int64_t)(value - 1)) - 1 : (int64_t)value);
+	}
+
+	// Returns false if the scale argument (if given) is invalid, after throwing.
+	static bool ParseScale(NODE_ARGUMENTS info, int at, int& scale) {
+		if (info.Length() <= at || info[at]->IsUndefined()) return true;
+		if (!info[at]->IsUint32()) {
+			ThrowTypeError(info, "Expected the scale to be a regular 32-bit unsigned integer");
+			return false;
+		}
+		uint32_t value = v8::Local<v8::Uint32>::Cast(info[at])->Value();
+		if (value > MAX_SCALE) {
+			ThrowRangeError(info, "Scale argument must be within 0 - 18");
+			return false;
+		}
+		scale = (int)value;
+		return true;
+	}
+
+	// Converts a mantissa from one scale to another, returning false if the
+	// result does not fit.
+	static inline bool Convert(int64_t mantissa, int scale, int target, Rounding rounding, int64_t& result) {
+		if (target >= scale) return Upscale(mantissa, target - scale, result);
+		Uint128 n = { 0, Magnitude(mantissa) };
+		return DivideByPowerOfTen(n, scale - target, mantissa < 0, rounding, result);
+	}
+
+	static inline bool Upscale(int64_t mantissa, int places, int64_t& result) {
+		const int64_t factor = (int64_t)POWERS_OF_TEN[places];
+		if (MultiplyOverflows(mantissa, factor)) return false;
+		result = mantissa * factor;
+		return true;
+	}
+
+	// Divides by up to 10^36 (the product of two mantissas at the largest
+	// scale), in two steps if the divisor does not fit in 64 bits.
+	static inline bool DivideByPowerOfTen(Uint128 n, int places, bool is_negative, Rounding rounding, int64_t& result) {
+		bool inexact = false;
+		if (places > MAX_SCALE) {
+			Uint128 quotient;
+			inexact = DivideWide(n, POWERS_OF_TEN[places - MAX_SCALE], quotient) != 0;
+			n = quotient;
+			places = MAX_SCALE;
+		}
+		return Integer::DivideRounded(n, POWERS_OF_TEN[places], is_negative, rounding, result, inexact);
+	}
+
+	// Both magnitudes are converted to the larger scale, which fits in 128 bits.
+	static int CompareValues(int64_t a, int a_scale, int64_t b, int b_scale) {
+		if ((a < 0) != (b < 0)) return a < 0 ? -1 : 1;
+		const int scale = std::max(a_scale, b_scale);
+		Uint128 x = MultiplyFull(Magnitude(a), POWERS_OF_TEN[scale - a_scale]);
+		Uint128 y = MultiplyFull(Magnitude(b), POWERS_OF_TEN[scale - b_scale]);
+		int order = x.high != y.high ? (x.high < y.high ? -1 : 1) : x.low != y.low ? (x.low < y.low ? -1 : 1) : 0;
+		return a < 0 ? -order : order;
+	}
+
+	// Writes the digits of the mantissa backwards from the end, and then moves
+	// the integer digits back by one to make room for the decimal point.
+	static char* WriteString(char* end, int64_t mantissa, int scale) {
+		bool is_negative = mantissa < 0;
+		char* slot = WriteDecimal(end, Magnitude(mantissa));
+		if (scale) {
+			while (end - slot <= scale) { *(--slot) = '0'; }
+			memmove(slot - 1, slot, (size_t)(end - slot - scale));
+			*(end - scale - 1) = '.';
+			--slot;
+		}
+		*(slot - 1) = '-';
+		return slot - is_negative;
+	}
+
+	static inline int GetScale(v8::Local<v8::Object> object) {
+		return (int)(static_cast<Int64Tag*>(object->GetAlignedPointerFromInternalField(0)) - TAGS) / 2;
+	}
+
+	// Like Integer::NewInstance(), without any shared instances.
+	static inline v8::Local<v8::Object> NewInstance(NODE_ARGUMENTS info, int64_t mantissa, int scale) { UseAddon;
+		v8::Local<v8::Object> object = v8::Local<v8::Object>::New(info.GetIsolate(), addon->decimalBlank)->Clone();
+		SetInt64(object, &TAGS[scale * 2], mantissa);
+		return object;
+	}
+
+	static inline void ReturnNew(NODE_ARGUMENTS info, int64_t mantissa, int scale) {
+		info.GetReturnValue().Set(NewInstance(info, mantissa, scale));
+	}
+
+	// Returns the receiver itself if an operation did not change it.
+	static inline void ReturnResult(NODE_ARGUMENTS info, int64_t mantissa, int scale, int64_t result, int result_scale) {
+		if (result == mantissa && result_scale == scale) return info.GetReturnValue().Set(info.This());
+		ReturnNew(info, result, result_scale);
+	}
+
+	static const int MAX_SCALE = 18;
+	static const int NO_SCALE = -1;
+	static const size_t STRING_BUFFER_LENGTH = 32;
+	static Int64Tag TAGS[2 * (MAX_SCALE + 1)];
+};
+
+Int64Tag Decimal::TAGS[2 * (Decimal::MAX_SCALE + 1)] = {
+	{ 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true },
+	{ 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true },
+	{ 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true },
+	{ 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true },
+	{ 0, false }, { 0, true }, { 0, false }, { 0, true }, { 0, false }, { 0, true },
+};
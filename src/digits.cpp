@@ -0,0 +1,101 @@
+// Helpers for handling ASCII digits eight at a time, within a 64-bit word.
+// Chunks are loaded so that the first character is always in the lowest byte.
+
+inline uint64_t LoadChunk(const uint8_t* data) {
+	uint64_t chunk;
+	memcpy(&chunk, data, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	chunk = __builtin_bswap64(chunk);
+#endif
+	return chunk;
+}
+
+// Sets the high bit of each byte that is within lo - hi. Every byte of the
+// chunk must be below 0x80, so that none of the additions carry.
+inline uint64_t BytesInRange(uint64_t chunk, uint8_t lo, uint8_t hi) {
+	const uint64_t ones = 0x0101010101010101;
+	return (chunk + ones * (0x80 - lo)) & ~(chunk + ones * (0x7f - hi)) & (ones * 0x80);
+}
+
+inline bool IsDecimalChunk(uint64_t chunk) {
+	return ((chunk & 0xf0f0f0f0f0f0f0f0) | (((chunk + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333;
+}
+
+inline bool IsHexChunk(uint64_t chunk) {
+	if (chunk & 0x8080808080808080) return false;
+	return (BytesInRange(chunk, '0', '9') | BytesInRange(chunk | 0x2020202020202020, 'a', 'f')) == 0x8080808080808080;
+}
+
+// Each step combines neighboring groups of digits (1 + 1, 2 + 2, then 4 + 4),
+// so eight digits take three steps instead of eight.
+inline uint32_t ParseDecimalChunk(uint64_t chunk) {
+	chunk -= 0x3030303030303030;
+	chunk = chunk * 10 + (chunk >> 8);
+	chunk = ((chunk & 0x000000ff000000ff) * 0x000f424000000064 + ((chunk >> 16) & 0x000000ff000000ff) * 0x0000271000000001) >> 32;
+	return (uint32_t)chunk;
+}
+
+inline uint32_t ParseHexChunk(uint64_t chunk) {
+	const uint64_t ones = 0x0101010101010101;
+	chunk = (chunk & (ones * 0x0f)) + ((chunk >> 6) & ones) * 9;
+	chunk = ((chunk << 4) + (chunk >> 8)) & 0x00ff00ff00ff00ff;
+	chunk = ((chunk << 8) + (chunk >> 16)) & 0x0000ffff0000ffff;
+	return (uint32_t)((chunk << 16) + (chunk >> 32));
+}
+
+static const char DIGIT_PAIRS[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const char DIGIT_CHARS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static const uint64_t POWERS_OF_TEN[20] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+	100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+	10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+	100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+inline int DecimalLength(uint64_t value) {
+	int length = 1;
+	for (; value >= 10000; value /= 10000) { length += 4; }
+	return length + (value >= 10) + (value >= 100) + (value >= 1000);
+}
+
+// Writes the digits of a value so that they end right before the given
+// pointer, and returns a pointer to the first one. Values are split into
+// groups of eight digits (dividing by a constant, which compiles to a
+// multiplication) so that the digits within each group can be produced two at
+// a time with 32-bit arithmetic.
+inline char* WriteDecimal(char* end, uint64_t value) {
+	while (value >= 100000000) {
+		uint32_t group = (uint32_t)(value % 100000000);
+		value /= 100000000;
+		for (int i = 0; i < 4; ++i) {
+			end -= 2;
+			memcpy(end, DIGIT_PAIRS + (group % 100) * 2, 2);
+			group /= 100;
+		}
+	}
+	uint32_t rest = (uint32_t)value;
+	while (rest >= 100) {
+		end -= 2;
+		memcpy(end, DIGIT_PAIRS + (rest % 100) * 2, 2);
+		rest /= 100;
+	}
+	if (rest >= 10) {
+		end -= 2;
+		memcpy(end, DIGIT_PAIRS + rest * 2, 2);
+	} else {
+		*(--end) = (char)('0' + rest);
+	}
+	return end;
+}
+
+// For radixes that are powers of two, each digit is just a group of bits.
+inline char* WritePowerOfTwo(char* end, uint64_t value, unsigned bits) {
+	const uint64_t mask = ((uint64_t)1 << bits) - 1;
+	do { *(--end) = DIGIT_CHARS[value & mask]; } while (value >>= bits);
+	return end;
+}
@@ -0,0 +1,385 @@
+// Hash tables keyed by raw 64-bit integers, exposed as Integer.Map and
+// Integer.Set. Keys are converted just like the arguments of Integer methods,
+// so looking one up never creates a string. Each table uses open addressing
+// with linear probing, where every key is stored in a BigInt64Array (an empty
+// slot holds MIN_VALUE), and a map's values are stored in a regular array at
+// the same indices. Since MIN_VALUE is a valid key too, it has its own slot
+// after the others, followed by the number of entries:
+//   [slot 0, ..., slot N-1, whether MIN_VALUE is present, size]
+// Deleted entries are replaced by the entries that follow them, so there are
+// never any tombstones to skip over. Slots are chosen with a seed that is
+// random for each environment (so every worker thread has its own), so that
+// keys cannot be picked (by whoever sends them) to collide.
+class HashTable {
+public:
+
+	static v8::Local<v8::FunctionTemplate> InitMap(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, NewMap, "IntegerMap");
+		t->InstanceTemplate()->SetInternalFieldCount(DATA_FIELD + 1);
+		SetPrototypeGetter(isolate, data, t, "size", Size);
+		SetPrototypeMethod(isolate, data, t, "get", Get);
+		SetPrototypeMethod(isolate, data, t, "set", Set);
+		SetPrototypeMethod(isolate, data, t, "has", Has);
+		SetPrototypeMethod(isolate, data, t, "delete", Delete);
+		SetPrototypeMethod(isolate, data, t, "clear", Clear);
+		SetPrototypeMethod(isolate, data, t, "keys", Keys);
+		SetPrototypeMethod(isolate, data, t, "values", Values);
+		SetPrototypeMethod(isolate, data, t, "forEach", ForEach);
+		return t;
+	}
+
+	static v8::Local<v8::FunctionTemplate> InitSet(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, NewSet, "IntegerSet");
+		t->InstanceTemplate()->SetInternalFieldCount(DATA_FIELD + 1);
+		SetPrototypeGetter(isolate, data, t, "size", Size);
+		SetPrototypeMethod(isolate, data, t, "add", Add);
+		SetPrototypeMethod(isolate, data, t, "has", Has);
+		SetPrototypeMethod(isolate, data, t, "delete", Delete);
+		SetPrototypeMethod(isolate, data, t, "clear", Clear);
+		SetPrototypeMethod(isolate, data, t, "keys", Keys);
+		SetPrototypeMethod(isolate, data, t, "forEach", ForEach);
+		return t;
+	}
+
+private:
+
+	// A view of a table's storage, which is only valid until JS code runs
+	// again (since any call could make the table grow).
+	struct Table {
+		Table(NODE_ARGUMENTS info) : object(info.This()) { UseAddon;
+			seed = addon->hashSeed;
+			keys = static_cast<int64_t*>(object->GetAlignedPointerFromInternalField(DATA_FIELD));
+			capacity = object->GetInternalField(KEYS_FIELD).As<v8::BigInt64Array>()->Length() - EXTRA_SLOTS;
+		}
+
+		inline size_t Size() const { return (size_t)keys[capacity + 1]; }
+		inline bool IsMap() const { return object->GetInternalField(VALUES_FIELD).As<v8::Value>()->IsArray(); }
+		inline v8::Local<v8::Array> Values() const { return object->GetInternalField(VALUES_FIELD).As<v8::Array>(); }
+
+		inline bool Occupied(size_t slot) const {
+			return slot < capacity ? keys[slot] != EMPTY : keys[capacity] != 0;
+		}
+
+		inline size_t Home(int64_t key) const {
+			return (size_t)(Integer::Mix((uint64_t)key ^ seed) & (capacity - 1));
+		}
+
+		// Returns the slot that holds the key, or the empty slot where it
+		// would be inserted.
+		inline size_t Find(int64_t key) const {
+			if (key == EMPTY) return capacity;
+			size_t slot = Home(key);
+			while (keys[slot] != key && keys[slot] != EMPTY) slot = (slot + 1) & (capacity - 1);
+			return slot;
+		}
+
+		// Marks the (empty) slot as holding the key, growing the table first if
+		// it would be too full. Returns the slot that now holds the key.
+		size_t Insert(v8::Isolate* isolate, size_t slot, int64_t key) {
+			size_t size = Size();
+			if (slot != capacity && (size + 1) * MAX_LOAD_DENOMINATOR > capacity * MAX_LOAD_NUMERATOR) {
+				Resize(isolate, capacity * 2);
+				slot = Find(key);
+			}
+			if (slot == capacity) keys[capacity] = 1;
+			else keys[slot] = key;
+			keys[capacity + 1] = (int64_t)(size + 1);
+			return slot;
+		}
+
+		// Each entry after the removed one is moved back into the gap, unless
+		// that would put it before its home slot.
+		void Remove(v8::Isolate* isolate, size_t slot) {
+			v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+			v8::Local<v8::Array> values;
+			if (IsMap()) values = Values();
+			keys[capacity + 1] -= 1;
+			if (slot == capacity) {
+				keys[capacity] = 0;
+				if (!values.IsEmpty()) SetValue(ctx, values, capacity, v8::Undefined(isolate));
+				return;
+			}
+			const size_t mask = capacity - 1;
+			size_t gap = slot;
+			for (size_t next = (gap + 1) & mask; keys[next] != EMPTY; next = (next + 1) & mask) {
+				size_t home = Home(keys[next]);
+				if (((next - home) & mask) < ((next - gap) & mask)) continue;
+				keys[gap] = keys[next];
+				if (!values.IsEmpty()) SetValue(ctx, values, gap, GetValue(ctx, values, next));
+				gap = next;
+			}
+			keys[gap] = EMPTY;
+			if (!values.IsEmpty()) SetValue(ctx, values, gap, v8::Undefined(isolate));
+		}
+
+		// Moves every entry into new storage of the given capacity.
+		void Resize(v8::Isolate* isolate, size_t new_capacity) {
+			v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+			const bool is_map = IsMap();
+			v8::Local<v8::Array> old_values;
+			if (is_map) old_values = Values();
+			// The old keys must stay reachable until they are copied.
+			v8::Local<v8::BigInt64Array> old_array = object->GetInternalField(KEYS_FIELD).As<v8::BigInt64Array>();
+			const int64_t* old_keys = Int64Data(old_array);
+			const size_t old_capacity = capacity;
+			Allocate(isolate, object, new_capacity, is_map);
+			keys = static_cast<int64_t*>(object->GetAlignedPointerFromInternalField(DATA_FIELD));
+			capacity = new_capacity;
+			v8::Local<v8::Array> values;
+			if (is_map) values = Values();
+			keys[capacity] = old_keys[old_capacity];
+			keys[capacity + 1] = old_keys[old_capacity + 1];
+			if (is_map && keys[capacity]) {
+				SetValue(ctx, values, capacity, GetValue(ctx, old_values, old_capacity));
+			}
+			for (size_t i = 0; i < old_capacity; ++i) {
+				if (old_keys[i] == EMPTY) continue;
+				size_t slot = Find(old_keys[i]);
+				keys[slot] = old_keys[i];
+				if (is_map) SetValue(ctx, values, slot, GetValue(ctx, old_values, i));
+			}
+		}
+
+		// Returns the key held by an occupied slot.
+		inline int64_t Key(size_t slot) const {
+			return slot < capacity ? keys[slot] : EMPTY;
+		}
+
+		v8::Local<v8::Object> object;
+		uint64_t seed;
+		int64_t* keys;
+		size_t capacity;
+	};
+
+	// Values are defined on the array (rather than assigned), so that no
+	// setters or getters on Array.prototype are ever run. Since the values are
+	// always plain data properties, these cannot fail.
+	static inline void SetValue(v8::Local<v8::Context> ctx, v8::Local<v8::Array> values, size_t slot, v8::Local<v8::Value> value) {
+		values->CreateDataProperty(ctx, (uint32_t)slot, value).FromJust();
+	}
+
+	static inline v8::Local<v8::Value> GetValue(v8::Local<v8::Context> ctx, v8::Local<v8::Array> values, size_t slot) {
+		return values->Get(ctx, (uint32_t)slot).ToLocalChecked();
+	}
+
+	// Gives the object new, empty storage of the given capacity.
+	static void Allocate(v8::Isolate* isolate, v8::Local<v8::Object> object, size_t capacity, bool is_map) {
+		v8::Local<v8::BigInt64Array> array = IntegerArray::Allocate(isolate, capacity + EXTRA_SLOTS);
+		int64_t* keys = Int64Data(array);
+		std::fill(keys, keys + capacity, EMPTY);
+		object->SetInternalField(KEYS_FIELD, array);
+		object->SetInternalField(VALUES_FIELD, is_map ? v8::Local<v8::Value>(v8::Array::New(isolate, (int)(capacity + 1))) : v8::Local<v8::Value>(v8::Undefined(isolate)));
+		object->SetAlignedPointerInInternalField(DATA_FIELD, keys);
+	}
+
+	NODE_METHOD(NewMap) {
+		if (!info.IsConstructCall()) return ThrowTypeError(info, "Class constructor IntegerMap cannot be invoked without 'new'");
+		Allocate(info.GetIsolate(), info.This(), MIN_CAPACITY, true);
+		if (info.Length() > 0 && !info[0]->IsUndefined()) {
+			if (!info[0]->IsArray()) return ThrowTypeError(info, "Expected first argument to be an array of [key, value] entries");
+			v8::Local<v8::Context> ctx = info.GetIsolate()->GetCurrentContext();
+			v8::Local<v8::Array> entries = v8::Local<v8::Array>::Cast(info[0]);
+			for (uint32_t i = 0, length = entries->Length(); i < length; ++i) {
+				v8::Local<v8::Value> entry;
+				v8::Local<v8::Value> key;
+				v8::Local<v8::Value> value;
+				if (!entries->Get(ctx, i).ToLocal(&entry)) return;
+				if (!entry->IsArray()) return ThrowTypeError(info, IntegerArray::MessageAtIndex("Expected an entry to be a [key, value] array", i).c_str());
+				if (!v8::Local<v8::Array>::Cast(entry)->Get(ctx, 0).ToLocal(&key)) return;
+				if (!v8::Local<v8::Array>::Cast(entry)->Get(ctx, 1).ToLocal(&value)) return;
+				if (!Store(info, key, value)) return;
+			}
+		}
+		info.GetReturnValue().Set(info.This());
+	}
+
+	// A set can be filled from an array of keys, a BigInt64Array, or an
+	// Integer.Array.
+	NODE_METHOD(NewSet) {
+		if (!info.IsConstructCall()) return ThrowTypeError(info, "Class constructor IntegerSet cannot be invoked without 'new'");
+		v8::Isolate* isolate = info.GetIsolate();
+		Allocate(isolate, info.This(), MIN_CAPACITY, false);
+		if (info.Length() > 0 && !info[0]->IsUndefined()) {
+			v8::Local<v8::BigInt64Array> other;
+			if (info[0]->IsBigInt64Array()) other = v8::Local<v8::BigInt64Array>::Cast(info[0]);
+			else if (IntegerArray::HasInstance(info[0])) other = IntegerArray::Elements(v8::Local<v8::Object>::Cast(info[0]));
+			if (!other.IsEmpty()) {
+				Table table(info);
+				const int64_t* elements = Int64Data(other);
+				for (size_t i = 0, length = other->Length(); i < length; ++i) {
+					size_t slot = table.Find(elements[i]);
+					if (!table.Occupied(slot)) table.Insert(isolate, slot, elements[i]);
+				}
+			} else if (info[0]->IsArray()) {
+				v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+				v8::Local<v8::Array> keys = v8::Local<v8::Array>::Cast(info[0]);
+				for (uint32_t i = 0, length = keys->Length(); i < length; ++i) {
+					v8::Local<v8::Value> key;
+					if (!keys->Get(ctx, i).ToLocal(&key)) return;
+					if (!Store(info, key, v8::Local<v8::Value>())) return;
+				}
+			} else {
+				return ThrowTypeError(info, "Expected first argument to be an array, BigInt64Array, or IntegerArray");
+			}
+		}
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_GETTER(Size) {
+		v8::Local<v8::Object> object = info.This();
+		const int64_t* keys = static_cast<int64_t*>(object->GetAlignedPointerFromInternalField(DATA_FIELD));
+		size_t capacity = object->GetInternalField(KEYS_FIELD).As<v8::BigInt64Array>()->Length() - EXTRA_SLOTS;
+		info.GetReturnValue().Set((double)keys[capacity + 1]);
+	}
+
+	NODE_METHOD(Get) {
+		int64_t key;
+		if (!UseKey(info, key)) return;
+		Table table(info);
+		size_t slot = table.Find(key);
+		if (!table.Occupied(slot)) return;
+		v8::Local<v8::Value> value;
+		if (table.Values()->Get(info.GetIsolate()->GetCurrentContext(), (uint32_t)slot).ToLocal(&value)) info.GetReturnValue().Set(value);
+	}
+
+	NODE_METHOD(Set) {
+		if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");
+		if (Store(info, info[0], info.Length() > 1 ? info[1] : v8::Local<v8::Value>(v8::Undefined(info.GetIsolate())))) {
+			info.GetReturnValue().Set(info.This());
+		}
+	}
+
+	NODE_METHOD(Add) {
+		if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");
+		if (Store(info, info[0], v8::Local<v8::Value>())) info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(Has) {
+		int64_t key;
+		if (!UseKey(info, key)) return;
+		Table table(info);
+		info.GetReturnValue().Set(table.Occupied(table.Find(key)));
+	}
+
+	NODE_METHOD(Delete) {
+		int64_t key;
+		if (!UseKey(info, key)) return;
+		Table table(info);
+		size_t slot = table.Find(key);
+		bool found = table.Occupied(slot);
+		if (found) table.Remove(info.GetIsolate(), slot);
+		info.GetReturnValue().Set(found);
+	}
+
+	NODE_METHOD(Clear) {
+		Table table(info);
+		Allocate(info.GetIsolate(), info.This(), MIN_CAPACITY, table.IsMap());
+	}
+
+	// Returns the keys as a new Integer.Array, in no particular order.
+	NODE_METHOD(Keys) {
+		Table table(info);
+		v8::Local<v8::BigInt64Array> result;
+		if (!IntegerArray::Allocate(info, table.Size(), result)) return;
+		int64_t* out = Int64Data(result);
+		for (size_t slot = 0, i = 0; slot <= table.capacity; ++slot) {
+			if (table.Occupied(slot)) out[i++] = table.Key(slot);
+		}
+		v8::Local<v8::Object> array;
+		if (IntegerArray::NewInstance(info, result).ToLocal(&array)) info.GetReturnValue().Set(array);
+	}
+
+	// Returns the values in the same order as keys().
+	NODE_METHOD(Values) {
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		Table table(info);
+		v8::Local<v8::Array> values = table.Values();
+		v8::Local<v8::Array> result = v8::Array::New(isolate, (int)table.Size());
+		for (size_t slot = 0, i = 0; slot <= table.capacity; ++slot) {
+			if (!table.Occupied(slot)) continue;
+			v8::Local<v8::Value> value;
+			if (!values->Get(ctx, (uint32_t)slot).ToLocal(&value)) return;
+			if (result->Set(ctx, (uint32_t)i++, value).IsNothing()) return;
+		}
+		info.GetReturnValue().Set(result);
+	}
+
+	// Calls the callback with (value, key, table) for a map, or (key, key,
+	// table) for a set, just like the built-in collections. Only the entries
+	// present when forEach() was called are visited, since the callback could
+	// change where every other entry is stored.
+	NODE_METHOD(ForEach) {
+		if (info.Length() == 0 || !info[0]->IsFunction()) return ThrowTypeError(info, "Expected first argument to be a function");
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		v8::Local<v8::Function> callback = v8::Local<v8::Function>::Cast(info[0]);
+		v8::Local<v8::Value> recv = info.Length() > 1 ? info[1] : v8::Local<v8::Value>(v8::Undefined(isolate));
+		Table table(info);
+		const bool is_map = table.IsMap();
+		const size_t size = table.Size();
+		std::vector<int64_t> keys;
+		keys.reserve(size);
+		v8::Local<v8::Array> values = v8::Array::New(isolate, is_map ? (int)size : 0);
+		for (size_t slot = 0; slot <= table.capacity; ++slot) {
+			if (!table.Occupied(slot)) continue;
+			if (is_map) {
+				v8::Local<v8::Value> value;
+				if (!table.Values()->Get(ctx, (uint32_t)slot).ToLocal(&value)) return;
+				if (values->Set(ctx, (uint32_t)keys.size(), value).IsNothing()) return;
+			}
+			keys.push_back(table.Key(slot));
+		}
+		for (size_t i = 0; i < keys.size(); ++i) {
+			v8::Local<v8::Object> key;
+			v8::Local<v8::Value> value;
+			if (!Integer::NewInstance(info, keys[i]).ToLocal(&key)) return;
+			if (!is_map) value = key;
+			else if (!values->Get(ctx, (uint32_t)i).ToLocal(&value)) return;
+			v8::Local<v8::Value> args[3] = { value, key, info.This() };
+			if (callback->Call(ctx, recv, 3, args).IsEmpty()) return;
+		}
+	}
+
+	// Inserts or replaces an entry, storing the value only if it's a map.
+	// Returns false if an exception was thrown.
+	static bool Store(NODE_ARGUMENTS info, v8::Local<v8::Value> key_value, v8::Local<v8::Value> value) {
+		Result cast = Integer::Cast(info, key_value);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		int64_t key = cast.Checked();
+		v8::Isolate* isolate = info.GetIsolate();
+		Table table(info);
+		size_t slot = table.Find(key);
+		if (!table.Occupied(slot)) slot = table.Insert(isolate, slot, key);
+		if (!value.IsEmpty()) SetValue(isolate->GetCurrentContext(), table.Values(), slot, value);
+		return true;
+	}
+
+	static bool UseKey(NODE_ARGUMENTS info, int64_t& key) {
+		if (info.Length() == 0) {
+			ThrowTypeError(info, "Missing argument");
+			return false;
+		}
+		Result cast = Integer::Cast(info, info[0]);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		key = cast.Checked();
+		return true;
+	}
+
+	static const int64_t EMPTY = INT64_MIN;
+	static const size_t EXTRA_SLOTS = 2;
+	static const size_t MIN_CAPACITY = 8;
+	// Tables grow when they would become more than 3/4 full.
+	static const size_t MAX_LOAD_NUMERATOR = 3;
+	static const size_t MAX_LOAD_DENOMINATOR = 4;
+
+	static const int KEYS_FIELD = 0;
+	static const int VALUES_FIELD = 1;
+	static const int DATA_FIELD = 2;
+};
@@ -0,0 +1,870 @@
+class IntegerArray {
+	// Pipelines run their steps with the same kernels.
+	friend class Pipeline;
+	// Shared arrays update their elements with the same overflow checks.
+	friend class SharedArray;
+	// Batch operations run the same kernels on the threadpool.
+	friend class Batch;
+
+public:
+
+	static v8::Local<v8::FunctionTemplate> Init(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, New, "IntegerArray");
+		t->InstanceTemplate()->SetInternalFieldCount(TAG_FIELD + 1);
+		SetPrototypeGetter(isolate, data, t, "length", Length);
+		SetPrototypeMethod(isolate, data, t, "get", Get);
+		SetPrototypeMethod(isolate, data, t, "set", Set);
+		SetPrototypeMethod(isolate, data, t, "add", Add);
+		SetPrototypeMethod(isolate, data, t, "subtract", Subtract);
+		SetPrototypeMethod(isolate, data, t, "multiply", Multiply);
+		SetPrototypeMethod(isolate, data, t, "divide", Divide);
+		SetPrototypeMethod(isolate, data, t, "modulo", Modulo);
+		SetPrototypeMethod(isolate, data, t, "and", And);
+		SetPrototypeMethod(isolate, data, t, "or", Or);
+		SetPrototypeMethod(isolate, data, t, "xor", Xor);
+		SetPrototypeMethod(isolate, data, t, "not", Not);
+		SetPrototypeMethod(isolate, data, t, "shiftLeft", ShiftLeft);
+		SetPrototypeMethod(isolate, data, t, "shiftRight", ShiftRight);
+		SetPrototypeMethod(isolate, data, t, "equals", Equals);
+		SetPrototypeMethod(isolate, data, t, "notEquals", NotEquals);
+		SetPrototypeMethod(isolate, data, t, "greaterThan", GreaterThan);
+		SetPrototypeMethod(isolate, data, t, "greaterThanOrEquals", GreaterThanOrEquals);
+		SetPrototypeMethod(isolate, data, t, "lessThan", LessThan);
+		SetPrototypeMethod(isolate, data, t, "lessThanOrEquals", LessThanOrEquals);
+		SetPrototypeMethod(isolate, data, t, "sum", Sum);
+		SetPrototypeMethod(isolate, data, t, "min", Min);
+		SetPrototypeMethod(isolate, data, t, "max", Max);
+		SetPrototypeMethod(isolate, data, t, "countNonZero", CountNonZero);
+		SetPrototypeMethod(isolate, data, t, "sort", Sort);
+		SetPrototypeMethod(isolate, data, t, "argsort", Argsort);
+		SetPrototypeMethod(isolate, data, t, "unique", Unique);
+		SetPrototypeMethod(isolate, data, t, "binarySearch", BinarySearch);
+		SetPrototypeMethod(isolate, data, t, "lowerBound", LowerBound);
+		SetPrototypeMethod(isolate, data, t, "upperBound", UpperBound);
+		SetPrototypeMethod(isolate, data, t, "intersection", Intersection);
+		SetPrototypeMethod(isolate, data, t, "union", Union);
+		SetPrototypeMethod(isolate, data, t, "difference", Difference);
+		SetPrototypeMethod(isolate, data, t, "asBigInt64Array", AsBigInt64Array);
+		SetPrototypeMethod(isolate, data, t, "toArray", ToArray);
+		SetPrototypeMethod(isolate, data, t, "writeText", WriteText);
+		SetPrototypeMethod(isolate, data, t, "writeTo", WriteTo);
+		SetPrototypeMethod(isolate, data, t, "writeVarints", WriteVarints);
+		SetStaticMethod(isolate, data, t, "from", From);
+		SetStaticMethod(isolate, data, t, "fromBuffer", FromBuffer);
+		SetStaticMethod(isolate, data, t, "fromVarints", FromVarints);
+		return t;
+	}
+
+	static inline v8::Local<v8::BigInt64Array> Elements(v8::Local<v8::Object> object) {
+		return object->GetInternalField(0).As<v8::BigInt64Array>();
+	}
+
+	// Like Integer::HasInstance, IntegerArrays are recognized by a tag that only
+	// they point to (which follows their elements).
+	static inline bool HasInstance(v8::Local<v8::Value> value) {
+		if (!value->IsObject()) return false;
+		v8::Local<v8::Object> object = v8::Local<v8::Object>::Cast(value);
+		if (object->InternalFieldCount() != TAG_FIELD + 1) return false;
+		return GetTagFromInternalField(object, TAG_FIELD) == &TAG;
+	}
+
+	// Wraps the given elements in a new IntegerArray without copying them.
+	static v8::MaybeLocal<v8::Object> NewInstance(NODE_ARGUMENTS info, v8::Local<v8::BigInt64Array> array) { UseAddon;
+		return NewInstance(info.GetIsolate(), addon, array);
+	}
+
+	static v8::MaybeLocal<v8::Object> NewInstance(v8::Isolate* isolate, Addon* addon, v8::Local<v8::BigInt64Array> array) {
+		v8::Local<v8::Value> arg = array;
+		return v8::Local<v8::Function>::New(isolate, addon->arrayConstructor)->NewInstance(isolate->GetCurrentContext(), 1, &arg);
+	}
+
+	// Returns false after throwing a RangeError (as the built-in typed array
+	// constructors do) if the array is too long to be allocated.
+	template <class Array, class Element = int64_t>
+	static inline bool Allocate(NODE_ARGUMENTS info, size_t length, v8::Local<Array>& array) {
+		if (NewTypedArray<Array, Element>(info.GetIsolate(), length, array)) return true;
+		ThrowRangeError(info, "Array buffer allocation failed");
+		return false;
+	}
+
+	// Only for lengths that are bounded by memory that is already allocated.
+	static inline v8::Local<v8::BigInt64Array> Allocate(v8::Isolate* isolate, size_t length) {
+		return v8::BigInt64Array::New(v8::ArrayBuffer::New(isolate, length * sizeof(int64_t)), 0, length);
+	}
+
+	// Exposed as Integer.parseMany(input, [radix, [separator]]). Every value is
+	// parsed without throwing, so invalid values cost no more than valid ones.
+	// The input is an array, or a Buffer of values separated by a single ASCII
+	// character (a trailing separator is ignored). The result holds the values
+	// (zero where invalid), a bitmap of which ones are valid, and the code of
+	// each value's error (zero where valid).
+	NODE_METHOD(ParseMany) { UseAddon;
+		if (info.Length() == 0 || !(info[0]->IsArray() || info[0]->IsUint8Array())) {
+			return ThrowTypeError(info, "Expected first argument to be an array, Buffer, or Uint8Array");
+		}
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		uint8_t radix;
+		uint8_t separator;
+		if (!ParseTextOptions(info, radix, separator)) return;
+
+		const uint8_t* data = NULL;
+		const uint8_t* end = NULL;
+		size_t length;
+		bool is_text = info[0]->IsUint8Array();
+		if (is_text) {
+			v8::Local<v8::Uint8Array> buffer = v8::Local<v8::Uint8Array>::Cast(info[0]);
+			data = static_cast<const uint8_t*>(BufferData(buffer->Buffer())) + buffer->ByteOffset();
+			end = data + buffer->ByteLength();
+			length = data == end ? 0 : std::count(data, end, separator) + (end[-1] != separator);
+		} else {
+			length = v8::Local<v8::Array>::Cast(info[0])->Length();
+		}
+
+		v8::Local<v8::BigInt64Array> values;
+		if (!Allocate(info, length, values)) return;
+		v8::Local<v8::Uint8Array> valid;
+		v8::Local<v8::Uint8Array> errors;
+		if (!Allocate<v8::Uint8Array, uint8_t>(info, (length + 7) / 8, valid) || !Allocate<v8::Uint8Array, uint8_t>(info, length, errors)) return;
+		ParsedValues parsed = {
+			Int64Data(values),
+			static_cast<uint8_t*>(BufferData(valid->Buffer())),
+			static_cast<uint8_t*>(BufferData(errors->Buffer())),
+		};
+		if (is_text) {
+			for (size_t i = 0; i < length; ++i) {
+				const uint8_t* field_end = static_cast<const uint8_t*>(memchr(data, separator, end - data));
+				if (!field_end) field_end = end;
+				parsed.Store(i, ParseField(data, (size_t)(field_end - data), radix));
+				data = field_end + 1;
+			}
+		} else {
+			v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(info[0]);
+			for (uint32_t i = 0; i < length; ++i) {
+				v8::Local<v8::Value> value;
+				if (!array->Get(ctx, i).ToLocal(&value)) return;
+				if (value->IsString()) parsed.Store(i, Integer::Cast(info, v8::Local<v8::String>::Cast(value), radix));
+				else parsed.Store(i, Integer::Cast(info, value));
+			}
+		}
+
+		Return(info, ParsedResult(isolate, addon, values, valid, errors));
+	}
+
+	// Parses the (radix, separator) arguments of Integer.parseMany().
+	static bool ParseTextOptions(NODE_ARGUMENTS info, uint8_t& radix, uint8_t& separator) {
+		uint32_t r = 10;
+		if (info.Length() > 1 && !info[1]->IsUndefined()) {
+			if (!info[1]->IsUint32()) {
+				ThrowTypeError(info, "Expected second argument to be a regular 32-bit unsigned integer");
+				return false;
+			}
+			r = v8::Local<v8::Uint32>::Cast(info[1])->Value();
+			if (r < 2 || r > 36) {
+				ThrowRangeError(info, "Radix argument must be within 2 - 36");
+				return false;
+			}
+		}
+		uint16_t c = ',';
+		if (info.Length() > 2 && !info[2]->IsUndefined()) {
+			bool is_valid = info[2]->IsString() && v8::Local<v8::String>::Cast(info[2])->Length() == 1;
+			if (is_valid) {
+				v8::Local<v8::String>::Cast(info[2])->Write(info.GetIsolate(), &c, 0, 1, v8::String::NO_NULL_TERMINATION);
+				is_valid = c <= 0x7f;
+			}
+			if (!is_valid) {
+				ThrowTypeError(info, "Expected the separator to be a single ASCII character");
+				return false;
+			}
+		}
+		radix = (uint8_t)r;
+		separator = (uint8_t)c;
+		return true;
+	}
+
+	static v8::MaybeLocal<v8::Object> ParsedResult(
+		v8::Isolate* isolate,
+		Addon* addon,
+		v8::Local<v8::BigInt64Array> values,
+		v8::Local<v8::Uint8Array> valid,
+		v8::Local<v8::Uint8Array> errors
+	) {
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		v8::Local<v8::Object> array;
+		if (!NewInstance(isolate, addon, values).ToLocal(&array)) return v8::MaybeLocal<v8::Object>();
+		v8::Local<v8::Object> result = v8::Object::New(isolate);
+		if (result->Set(ctx, InternalizedFromLatin1(isolate, "values"), array).IsNothing()) return v8::MaybeLocal<v8::Object>();
+		if (result->Set(ctx, InternalizedFromLatin1(isolate, "valid"), valid).IsNothing()) return v8::MaybeLocal<v8::Object>();
+		if (result->Set(ctx, InternalizedFromLatin1(isolate, "errors"), errors).IsNothing()) return v8::MaybeLocal<v8::Object>();
+		return result;
+	}
+
+	// Each kernel writes every output element, then returns the index of the
+	// first element that failed its overflow or divide-by-zero check (or the
+	// length, if none failed). Checks are accumulated branch-free over each
+	// chunk so the inner loops can be vectorized (except for multiplication,
+	// which has no vector form of its check); a chunk is only rescanned with
+	// the scalar check if something inside of it failed.
+	template <class Op, class Operand>
+	static size_t Map(const int64_t* __restrict a, Operand b, int64_t* __restrict out, size_t length) {
+		for (size_t start = 0; start < length; start += CHUNK_LENGTH) {
+			size_t end = std::min(length, start + CHUNK_LENGTH);
+			int64_t flags = 0;
+			for (size_t i = start; i < end; ++i) {
+				int64_t x = a[i], y = b[i], r = Op::Apply(x, y);
+				flags |= Op::Flag(x, y, r);
+				out[i] = r;
+			}
+			if (flags < 0) {
+				for (size_t i = start; i < end; ++i) if (Op::Check(a[i], b[i])) return i;
+			}
+		}
+		return length;
+	}
+
+	template <class Op, class Operand>
+	static void Compare(const int64_t* __restrict a, Operand b, uint8_t* __restrict out, size_t length) {
+		for (size_t i = 0; i < length; ++i) out[i] = Op::Apply(a[i], b[i]);
+	}
+
+	// Adds every element to the result, which is left unchanged on overflow.
+	static size_t Sum(const int64_t* a, size_t length, int64_t& result) {
+		int64_t sum = result;
+		for (size_t start = 0; start < length; start += CHUNK_LENGTH) {
+			size_t end = std::min(length, start + CHUNK_LENGTH);
+			int64_t partial = sum;
+			int64_t flags = 0;
+			for (size_t i = start; i < end; ++i) {
+				int64_t r = WrappingAdd(partial, a[i]);
+				flags |= AddOverflowBits(partial, a[i], r);
+				partial = r;
+			}
+			if (flags < 0) {
+				for (size_t i = start;; ++i) {
+					if (AddOverflows(sum, a[i])) return i;
+					sum += a[i];
+				}
+			}
+			sum = partial;
+		}
+		result = sum;
+		return length;
+	}
+
+	static int64_t Min(const int64_t* a, size_t length) {
+		int64_t result = INT64_MAX;
+		for (size_t i = 0; i < length; ++i) result = a[i] < result ? a[i] : result;
+		return result;
+	}
+
+	static int64_t Max(const int64_t* a, size_t length) {
+		int64_t result = INT64_MIN;
+		for (size_t i = 0; i < length; ++i) result = a[i] > result ? a[i] : result;
+		return result;
+	}
+
+	static size_t CountNonZero(const int64_t* a, size_t length) {
+		size_t count = 0;
+		for (size_t i = 0; i < length; ++i) count += a[i] != 0;
+		return count;
+	}
+
+	static void ThrowAtIndex(NODE_ARGUMENTS info, const Error& error, size_t index) {
+		ThrowException(info, Error(MessageAtIndex(error.message, index).c_str(), error));
+	}
+	static void ThrowAtIndex(NODE_ARGUMENTS info, const char* message, size_t index) {
+		ThrowAtIndex(info, Error(message, true), index);
+	}
+
+	static std::string MessageAtIndex(const char* message, size_t index) {
+		std::string text = message;
+		text += " at index ";
+		text += std::to_string(index);
+		return text;
+	}
+
+private:
+
+	NODE_METHOD(New) {
+		if (!info.IsConstructCall()) return ThrowTypeError(info, "Class constructor IntegerArray cannot be invoked without 'new'");
+		v8::Local<v8::BigInt64Array> array;
+		if (info.Length() == 0 || info[0]->IsUint32()) {
+			if (!Allocate(info, info.Length() ? v8::Local<v8::Uint32>::Cast(info[0])->Value() : 0, array)) return;
+		} else if (info[0]->IsBigInt64Array()) {
+			array = v8::Local<v8::BigInt64Array>::Cast(info[0]);
+		} else if (HasInstance(info[0])) {
+			array = Elements(v8::Local<v8::Object>::Cast(info[0]));
+		} else if (info[0]->IsArrayBuffer()) {
+			v8::Local<v8::ArrayBuffer> buffer = v8::Local<v8::ArrayBuffer>::Cast(info[0]);
+			size_t byteLength = buffer->ByteLength();
+			uint32_t byteOffset = 0;
+			if (info.Length() > 1) { REQUIRE_ARGUMENT_UINT32(second, byteOffset); }
+			if (byteOffset % sizeof(int64_t) != 0) return ThrowRangeError(info, "Byte offset must be a multiple of 8");
+			if (byteOffset > byteLength) return ThrowRangeError(info, "Byte offset is out of bounds");
+			size_t length = (byteLength - byteOffset) / sizeof(int64_t);
+			if (info.Length() > 2) {
+				size_t requested;
+				REQUIRE_ARGUMENT_UINT32(third, requested);
+				if (requested > length) return ThrowRangeError(info, "Length is out of bounds");
+				length = requested;
+			}
+			array = v8::BigInt64Array::New(buffer, byteOffset, length);
+		} else {
+			return ThrowTypeError(info, "Expected a length, BigInt64Array, ArrayBuffer, or IntegerArray");
+		}
+		info.This()->SetInternalField(0, array);
+		info.This()->SetAlignedPointerInInternalField(TAG_FIELD, &TAG);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(From) {
+		if (info.Length() == 0 || !info[0]->IsArray()) return ThrowTypeError(info, "Expected first argument to be an array");
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		v8::Local<v8::Array> values = v8::Local<v8::Array>::Cast(info[0]);
+		uint32_t length = values->Length();
+		v8::Local<v8::BigInt64Array> array;
+		if (!Allocate(info, length, array)) return;
+		int64_t* elements = Int64Data(array);
+		for (uint32_t i = 0; i < length; ++i) {
+			v8::Local<v8::Value> value;
+			if (!values->Get(ctx, i).ToLocal(&value)) return;
+			Result cast = Integer::Cast(info, value);
+			if (cast.error) return ThrowException(info, *cast.error);
+			elements[i] = cast.Checked();
+		}
+		Return(info, NewInstance(info, array));
+	}
+
+	// The bulk decoders take (buffer, [offset, [count, [options]]]), where the
+	// count defaults to every value that fits in the rest of the buffer.
+	NODE_METHOD(FromBuffer) {
+		BinaryOptions options;
+		BufferArgument buffer;
+		size_t requested;
+		if (!ParseBinaryOptions(info, 3, options) || !ParseCount(info, requested) || !buffer.Parse(info, 0)) return;
+		size_t length = requested == NO_COUNT ? buffer.Available() / FIXED_LENGTH : requested;
+		if (length > buffer.Available() / FIXED_LENGTH) return ThrowRangeError(info, "The buffer is too small");
+		v8::Local<v8::BigInt64Array> array;
+		if (!Allocate(info, length, array)) return;
+		int64_t* elements = Int64Data(array);
+		const uint8_t* data = buffer.data + buffer.offset;
+		for (size_t i = 0; i < length; ++i) elements[i] = (int64_t)DecodeFixed(data + i * FIXED_LENGTH, options.big_endian);
+		Return(info, NewInstance(info, array));
+	}
+
+	NODE_METHOD(FromVarints) {
+		BinaryOptions options;
+		BufferArgument buffer;
+		size_t requested;
+		if (!ParseBinaryOptions(info, 3, options) || !ParseCount(info, requested) || !buffer.Parse(info, 0)) return;
+		const uint8_t* data = buffer.data + buffer.offset;
+		const size_t available = buffer.Available();
+		size_t length = requested == NO_COUNT ? CountVarints(data, available) : requested;
+		// Every varint takes at least one byte.
+		if (length > available) return ThrowRangeError(info, "The buffer is too small");
+		v8::Local<v8::BigInt64Array> array;
+		if (!Allocate(info, length, array)) return;
+		int64_t* elements = Int64Data(array);
+		size_t decoded;
+		size_t read = DecodeVarints(data, available, reinterpret_cast<uint64_t*>(elements), length, decoded);
+		if (decoded < length || (requested == NO_COUNT && read < available)) {
+			return ThrowAtIndex(info, VarintError(data + read, available - read), decoded);
+		}
+		if (options.zigzag) {
+			for (size_t i = 0; i < length; ++i) elements[i] = ZigZagDecode((uint64_t)elements[i]);
+		}
+		Return(info, NewInstance(info, array));
+	}
+
+	NODE_GETTER(Length) {
+		info.GetReturnValue().Set((double)Elements(info.This())->Length());
+	}
+
+	NODE_METHOD(Get) { UseElements;
+		REQUIRE_ARGUMENT_UINT32(first, uint32_t index);
+		if (index >= length) return ThrowRangeError(info, "Index is out of bounds");
+		Integer::ReturnNew(info, elements[index]);
+	}
+
+	NODE_METHOD(Set) { UseElements;
+		REQUIRE_ARGUMENT_UINT32(first, uint32_t index);
+		if (index >= length) return ThrowRangeError(info, "Index is out of bounds");
+		if (info.Length() < 2) return ThrowTypeError(info, "Missing argument");
+		Result cast = Integer::Cast(info, info[1]);
+		if (cast.error) return ThrowException(info, *cast.error);
+		elements[index] = cast.Checked();
+	}
+
+	NODE_METHOD(Add) { ReturnMapped<AddOp>(info); }
+	NODE_METHOD(Subtract) { ReturnMapped<SubtractOp>(info); }
+	NODE_METHOD(Multiply) { ReturnMapped<MultiplyOp>(info); }
+	NODE_METHOD(Divide) { ReturnMapped<DivideOp>(info); }
+	NODE_METHOD(Modulo) { ReturnMapped<ModuloOp>(info); }
+	NODE_METHOD(And) { ReturnMapped<AndOp>(info); }
+	NODE_METHOD(Or) { ReturnMapped<OrOp>(info); }
+	NODE_METHOD(Xor) { ReturnMapped<XorOp>(info); }
+
+	NODE_METHOD(Not) { UseElements;
+		v8::Local<v8::BigInt64Array> result;
+		if (!Allocate(info, length, result)) return;
+		Map<XorOp>(elements, Same(-1), Int64Data(result), length);
+		Return(info, NewInstance(info, result));
+	}
+
+	NODE_METHOD(ShiftLeft) { ReturnShifted<ShiftLeftOp>(info); }
+	NODE_METHOD(ShiftRight) { ReturnShifted<ShiftRightOp>(info); }
+
+	NODE_METHOD(Equals) { ReturnCompared<EqualsOp>(info); }
+	NODE_METHOD(NotEquals) { ReturnCompared<NotEqualsOp>(info); }
+	NODE_METHOD(GreaterThan) { ReturnCompared<GreaterThanOp>(info); }
+	NODE_METHOD(GreaterThanOrEquals) { ReturnCompared<GreaterThanOrEqualsOp>(info); }
+	NODE_METHOD(LessThan) { ReturnCompared<LessThanOp>(info); }
+	NODE_METHOD(LessThanOrEquals) { ReturnCompared<LessThanOrEqualsOp>(info); }
+
+	NODE_METHOD(Sum) { UseElements;
+		int64_t result = 0;
+		size_t index = Sum(elements, length, result);
+		if (index != length) return ThrowAtIndex(info, Error::INTEGER_OVERFLOW, index);
+		Integer::ReturnNew(info, result);
+	}
+
+	NODE_METHOD(Min) { UseElements;
+		if (length) Integer::ReturnNew(info, Min(elements, length));
+	}
+
+	NODE_METHOD(Max) { UseElements;
+		if (length) Integer::ReturnNew(info, Max(elements, length));
+	}
+
+	NODE_METHOD(CountNonZero) { UseElements;
+		info.GetReturnValue().Set((double)CountNonZero(elements, length));
+	}
+
+	// Like the other bulk operations, sorting returns a new array.
+	NODE_METHOD(Sort) {
+		bool descending;
+		if (!ParseSortOptions(info, descending)) return;
+		UseElements;
+		v8::Local<v8::BigInt64Array> result;
+		if (!Allocate(info, length, result)) return;
+		SortValues(elements, Int64Data(result), length, descending);
+		Return(info, NewInstance(info, result));
+	}
+
+	NODE_METHOD(Argsort) {
+		bool descending;
+		if (!ParseSortOptions(info, descending)) return;
+		UseElements;
+		if (length > UINT32_MAX) return ThrowRangeError(info, "The array is too large to be indexed by a Uint32Array");
+		v8::Local<v8::Uint32Array> result;
+		if (!Allocate<v8::Uint32Array, uint32_t>(info, length, result)) return;
+		SortIndices(elements, static_cast<uint32_t*>(BufferData(result->Buffer())), length, descending);
+		info.GetReturnValue().Set(result);
+	}
+
+	// Only the unique values are kept, at the start of the sorted buffer.
+	NODE_METHOD(Unique) { UseElements;
+		v8::Local<v8::BigInt64Array> result;
+		if (!Allocate(info, length, result)) return;
+		int64_t* out = Int64Data(result);
+		SortValues(elements, out, length, false);
+		size_t count = std::unique(out, out + length) - out;
+		if (count != length) result = v8::BigInt64Array::New(result->Buffer(), 0, count);
+		Return(info, NewInstance(info, result));
+	}
+
+	// The searches and set operations expect arrays sorted in ascending order.
+	NODE_METHOD(BinarySearch) { UseElements;
+		int64_t value;
+		if (!UseOperand(info, value)) return;
+		const int64_t* found = std::lower_bound(elements, elements + length, value);
+		info.GetReturnValue().Set(found != elements + length && *found == value ? (double)(found - elements) : -1.0);
+	}
+
+	NODE_METHOD(LowerBound) { UseElements;
+		int64_t value;
+		if (!UseOperand(info, value)) return;
+		info.GetReturnValue().Set((double)(std::lower_bound(elements, elements + length, value) - elements));
+	}
+
+	NODE_METHOD(UpperBound) { UseElements;
+		int64_t value;
+		if (!UseOperand(info, value)) return;
+		info.GetReturnValue().Set((double)(std::upper_bound(elements, elements + length, value) - elements));
+	}
+
+	NODE_METHOD(Intersection) { ReturnMerged<IntersectionOp>(info); }
+	NODE_METHOD(Union) { ReturnMerged<UnionOp>(info); }
+	NODE_METHOD(Difference) { ReturnMerged<DifferenceOp>(info); }
+
+	NODE_METHOD(AsBigInt64Array) {
+		info.GetReturnValue().Set(Elements(info.This()));
+	}
+
+	NODE_METHOD(ToArray) { UseElements;
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		v8::Local<v8::Array> result = v8::Array::New(isolate, (int)length);
+		for (size_t i = 0; i < length; ++i) {
+			v8::Local<v8::Object> integer;
+			if (!Integer::NewInstance(info, elements[i]).ToLocal(&integer)) return;
+			if (result->Set(ctx, (uint32_t)i, integer).IsNothing()) return;
+		}
+		info.GetReturnValue().Set(result);
+	}
+
+	NODE_METHOD(WriteText) { UseElements;
+		Integer::TextWriter writer;
+		if (!writer.Open(info, 0)) return;
+		for (size_t i = 0; i < length; ++i) {
+			if (!writer.Write(elements[i])) return ThrowRangeError(info, "The buffer is too small");
+		}
+		info.GetReturnValue().Set((double)writer.Offset());
+	}
+
+	NODE_METHOD(WriteTo) {
+		BinaryOptions options;
+		BufferArgument buffer;
+		if (!ParseBinaryOptions(info, 2, options) || !buffer.Parse(info, 0)) return;
+		UseElements;
+		if (length > buffer.Available() / FIXED_LENGTH) return ThrowRangeError(info, "The buffer is too small");
+		uint8_t* data = buffer.data + buffer.offset;
+		for (size_t i = 0; i < length; ++i) EncodeFixed(data + i * FIXED_LENGTH, (uint64_t)elements[i], options.big_endian);
+		info.GetReturnValue().Set((double)(buffer.offset + length * FIXED_LENGTH));
+	}
+
+	NODE_METHOD(WriteVarints) {
+		BinaryOptions options;
+		BufferArgument buffer;
+		if (!ParseBinaryOptions(info, 2, options) || !buffer.Parse(info, 0)) return;
+		UseElements;
+		// The exact length is only needed when the worst case does not fit, and
+		// is computed before writing, so that nothing is written if it throws.
+		if (length > buffer.Available() / MAX_VARINT_LENGTH) {
+			size_t required = 0;
+			for (size_t i = 0; i < length; ++i) {
+				required += VarintSize(options.zigzag ? ZigZagEncode(elements[i]) : (uint64_t)elements[i]);
+			}
+			if (required > buffer.Available()) return ThrowRangeError(info, "The buffer is too small");
+		}
+		uint8_t* data = buffer.data + buffer.offset;
+		for (size_t i = 0; i < length; ++i) {
+			data = EncodeVarint(data, options.zigzag ? ZigZagEncode(elements[i]) : (uint64_t)elements[i]);
+		}
+		info.GetReturnValue().Set((double)(data - buffer.data));
+	}
+
+	// The right-hand side of a bulk operation is either another array of the
+	// same length, or a single value (anything accepted by Integer::Cast).
+	struct Each {
+		explicit Each(const int64_t* _data) : data(_data) {}
+		inline int64_t operator[](size_t i) const { return data[i]; }
+		const int64_t* const data;
+	};
+	struct Same {
+		explicit Same(int64_t _value) : value(_value) {}
+		inline int64_t operator[](size_t) const { return value; }
+		const int64_t value;
+	};
+
+	// Returns false if an exception was thrown.
+	static bool UseOperand(NODE_ARGUMENTS info, size_t length, const int64_t*& data, int64_t& scalar) {
+		if (info.Length() == 0) {
+			ThrowTypeError(info, "Missing argument");
+			return false;
+		}
+		v8::Local<v8::Value> value = info[0];
+		v8::Local<v8::BigInt64Array> other;
+		if (value->IsBigInt64Array()) other = v8::Local<v8::BigInt64Array>::Cast(value);
+		else if (HasInstance(value)) other = Elements(v8::Local<v8::Object>::Cast(value));
+		if (!other.IsEmpty()) {
+			if (other->Length() != length) {
+				ThrowRangeError(info, "Expected arrays of equal length");
+				return false;
+			}
+			data = Int64Data(other);
+			return true;
+		}
+		Result cast = Integer::Cast(info, value);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		data = NULL;
+		scalar = cast.Checked();
+		return true;
+	}
+
+	// The searches only take a single value.
+	static bool UseOperand(NODE_ARGUMENTS info, int64_t& value) {
+		if (info.Length() == 0) {
+			ThrowTypeError(info, "Missing argument");
+			return false;
+		}
+		Result cast = Integer::Cast(info, info[0]);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		value = cast.Checked();
+		return true;
+	}
+
+	template <class Op>
+	static void ReturnMapped(NODE_ARGUMENTS info) { UseElements;
+		const int64_t* other;
+		int64_t scalar = 0;
+		if (!UseOperand(info, length, other, scalar)) return;
+		v8::Local<v8::BigInt64Array> result;
+		if (!Allocate(info, length, result)) return;
+		int64_t* out = Int64Data(result);
+		size_t index = other
+			? Map<Op>(elements, Each(other), out, length)
+			: Map<Op>(elements, Same(scalar), out, length);
+		if (index != length) {
+			return ThrowAtIndex(info, *Op::Check(elements[index], other ? other[index] : scalar), index);
+		}
+		Return(info, NewInstance(info, result));
+	}
+
+	template <class Op>
+	static void ReturnShifted(NODE_ARGUMENTS info) { UseElements;
+		REQUIRE_ARGUMENT_UINT32(first, uint32_t shift);
+		v8::Local<v8::BigInt64Array> result;
+		if (!Allocate(info, length, result)) return;
+		Map<Op>(elements, Same(shift & 63), Int64Data(result), length);
+		Return(info, NewInstance(info, result));
+	}
+
+	template <class Op>
+	static void ReturnCompared(NODE_ARGUMENTS info) { UseElements;
+		const int64_t* other;
+		int64_t scalar = 0;
+		if (!UseOperand(info, length, other, scalar)) return;
+		v8::Local<v8::Uint8Array> result;
+		if (!Allocate<v8::Uint8Array, uint8_t>(info, length, result)) return;
+		uint8_t* out = static_cast<uint8_t*>(BufferData(result->Buffer()));
+		if (other) Compare<Op>(elements, Each(other), out, length);
+		else Compare<Op>(elements, Same(scalar), out, length);
+		info.GetReturnValue().Set(result);
+	}
+
+	static bool ParseSortOptions(NODE_ARGUMENTS info, bool& descending) {
+		descending = false;
+		if (info.Length() == 0 || info[0]->IsUndefined()) return true;
+		if (!info[0]->IsObject()) {
+			ThrowTypeError(info, "Expected the options to be an object");
+			return false;
+		}
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Value> value;
+		if (!v8::Local<v8::Object>::Cast(info[0])->Get(isolate->GetCurrentContext(), InternalizedFromLatin1(isolate, "descending")).ToLocal(&value)) return false;
+		if (value->IsUndefined()) return true;
+		if (!value->IsBoolean()) {
+			ThrowTypeError(info, "Expected the descending option to be a boolean");
+			return false;
+		}
+		descending = value->IsTrue();
+		return true;
+	}
+
+	// The set operations merge two sorted arrays in a single pass. Duplicates
+	// are matched one-to-one (as in std::set_union), so unique inputs give
+	// unique results. Each merge is run twice, first to count the results, so
+	// that the new array is allocated with its exact length.
+	template <class Op>
+	static void ReturnMerged(NODE_ARGUMENTS info) { UseElements;
+		v8::Local<v8::BigInt64Array> other;
+		if (info.Length() > 0 && info[0]->IsBigInt64Array()) other = v8::Local<v8::BigInt64Array>::Cast(info[0]);
+		else if (info.Length() > 0 && HasInstance(info[0])) other = Elements(v8::Local<v8::Object>::Cast(info[0]));
+		else return ThrowTypeError(info, "Expected first argument to be an IntegerArray or BigInt64Array");
+		const int64_t* b = Int64Data(other);
+		const size_t b_length = other->Length();
+		size_t count = Op::Merge(elements, elements + length, b, b + b_length, Counter()).count;
+		v8::Local<v8::BigInt64Array> result;
+		if (!Allocate(info, count, result)) return;
+		Op::Merge(elements, elements + length, b, b + b_length, Int64Data(result));
+		Return(info, NewInstance(info, result));
+	}
+
+	// An output iterator that only counts what is written to it.
+	struct Counter {
+		typedef std::output_iterator_tag iterator_category;
+		typedef void value_type;
+		typedef void difference_type;
+		typedef void pointer;
+		typedef void reference;
+		Counter() : count(0) {}
+		inline Counter& operator*() { return *this; }
+		inline Counter& operator=(int64_t) { ++count; return *this; }
+		inline Counter& operator++() { return *this; }
+		inline Counter operator++(int) { return *this; }
+		size_t count;
+	};
+
+	struct IntersectionOp {
+		template <class Out>
+		static inline Out Merge(const int64_t* a, const int64_t* a_end, const int64_t* b, const int64_t* b_end, Out out) {
+			return std::set_intersection(a, a_end, b, b_end, out);
+		}
+	};
+	struct UnionOp {
+		template <class Out>
+		static inline Out Merge(const int64_t* a, const int64_t* a_end, const int64_t* b, const int64_t* b_end, Out out) {
+			return std::set_union(a, a_end, b, b_end, out);
+		}
+	};
+	struct DifferenceOp {
+		template <class Out>
+		static inline Out Merge(const int64_t* a, const int64_t* a_end, const int64_t* b, const int64_t* b_end, Out out) {
+			return std::set_difference(a, a_end, b, b_end, out);
+		}
+	};
+
+	struct ParsedValues {
+		int64_t* values;
+		uint8_t* valid;
+		uint8_t* errors;
+
+		inline void Store(size_t i, Result result) {
+			if (result.error) {
+				errors[i] = result.error->code;
+			} else {
+				values[i] = result.Checked();
+				valid[i >> 3] |= (uint8_t)(1 << (i & 7));
+			}
+		}
+	};
+
+	// Fields are parsed straight from the buffer, trying the fast path first
+	// just like Integer::Cast does for strings.
+	static inline Result ParseField(const uint8_t* str, size_t length, uint8_t radix) {
+		if (length > (size_t)INT32_MAX) return Result(Error::TOO_LARGE);
+		int64_t value;
+		if ((radix == 10 || radix == 16) && Integer::ParseDigits(str, (int)length, radix, value)) return Result(value);
+		return Integer::Parse(str, (int)length, radix);
+	}
+
+	// No count can be this large, since it comes from a 32-bit argument.
+	static const size_t NO_COUNT = SIZE_MAX;
+
+	static bool ParseCount(NODE_ARGUMENTS info, size_t& count) {
+		count = NO_COUNT;
+		if (info.Length() <= 2 || info[2]->IsUndefined()) return true;
+		if (!info[2]->IsUint32()) {
+			ThrowTypeError(info, "Expected the count to be a regular 32-bit unsigned integer");
+			return false;
+		}
+		count = v8::Local<v8::Uint32>::Cast(info[2])->Value();
+		return true;
+	}
+
+	static inline void Return(NODE_ARGUMENTS info, v8::MaybeLocal<v8::Object> object) {
+		v8::Local<v8::Object> result;
+		if (object.ToLocal(&result)) info.GetReturnValue().Set(result);
+	}
+
+	// Each operation provides the (non-throwing) result, a branch-free flag
+	// that is negative if the operation failed, and the scalar check that
+	// reports why it failed. Operations that cannot fail return a zero flag,
+	// which lets the compiler drop the check entirely.
+	struct AddOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return WrappingAdd(a, b); }
+		static inline int64_t Flag(int64_t a, int64_t b, int64_t r) { return AddOverflowBits(a, b, r); }
+		static inline const Error* Check(int64_t a, int64_t b) { return AddOverflows(a, b) ? &Error::INTEGER_OVERFLOW : NULL; }
+	};
+	struct SubtractOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return WrappingSubtract(a, b); }
+		static inline int64_t Flag(int64_t a, int64_t b, int64_t r) { return SubtractOverflowBits(a, b, r); }
+		static inline const Error* Check(int64_t a, int64_t b) { return SubtractOverflows(a, b) ? &Error::INTEGER_OVERFLOW : NULL; }
+	};
+	struct MultiplyOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return (int64_t)((uint64_t)a * (uint64_t)b); }
+		static inline int64_t Flag(int64_t a, int64_t b, int64_t) { return MultiplyOverflowBits(a, b); }
+		static inline const Error* Check(int64_t a, int64_t b) { return MultiplyOverflows(a, b) ? &Error::INTEGER_OVERFLOW : NULL; }
+	};
+	struct DivideOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return b == 0 || DivideOverflows(a, b) ? 0 : a / b; }
+		static inline int64_t Flag(int64_t a, int64_t b, int64_t) { return -(int64_t)(b == 0 || DivideOverflows(a, b)); }
+		static inline const Error* Check(int64_t a, int64_t b) { return b == 0 ? &Error::DIVIDE_BY_ZERO : DivideOverflows(a, b) ? &Error::INTEGER_OVERFLOW : NULL; }
+	};
+	struct ModuloOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return b == 0 || b == -1 ? 0 : a % b; }
+		static inline int64_t Flag(int64_t, int64_t b, int64_t) { return -(int64_t)(b == 0); }
+		static inline const Error* Check(int64_t, int64_t b) { return b == 0 ? &Error::DIVIDE_BY_ZERO : NULL; }
+	};
+	struct AndOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return a & b; }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	struct OrOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return a | b; }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	struct XorOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return a ^ b; }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	struct ShiftLeftOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return (int64_t)((uint64_t)a << b); }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	struct ShiftRightOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return a >> b; }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	// These have no Integer.Array method, and are only used by pipelines.
+	struct AbsOp {
+		static inline int64_t Apply(int64_t a, int64_t) { return a < 0 ? (int64_t)(0 - (uint64_t)a) : a; }
+		static inline int64_t Flag(int64_t a, int64_t, int64_t r) { return a & r; }
+		static inline const Error* Check(int64_t a, int64_t) { return a == INT64_MIN ? &Error::INTEGER_OVERFLOW : NULL; }
+	};
+	struct MinOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return a < b ? a : b; }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	struct MaxOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return a > b ? a : b; }
+		static inline int64_t Flag(int64_t, int64_t, int64_t) { return 0; }
+		static inline const Error* Check(int64_t, int64_t) { return NULL; }
+	};
+	struct PowOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { int64_t r; Power(a, b, r); return r; }
+		static inline int64_t Flag(int64_t a, int64_t b, int64_t) { int64_t r; return -(int64_t)!Power(a, b, r); }
+		static inline const Error* Check(int64_t a, int64_t b) { int64_t r; return Power(a, b, r) ? NULL : &Error::INTEGER_OVERFLOW; }
+	};
+	struct GcdOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { return (int64_t)GreatestCommonDivisor(Magnitude(a), Magnitude(b)); }
+		static inline int64_t Flag(int64_t, int64_t, int64_t r) { return r; }
+		static inline const Error* Check(int64_t a, int64_t b) { return Apply(a, b) < 0 ? &Error::INTEGER_OVERFLOW : NULL; }
+	};
+	struct LcmOp {
+		static inline int64_t Apply(int64_t a, int64_t b) { int64_t r; LeastCommonMultiple(a, b, r); return r; }
+		static inline int64_t Flag(int64_t a, int64_t b, int64_t) { int64_t r; return -(int64_t)!LeastCommonMultiple(a, b, r); }
+		static inline const Error* Check(int64_t a, int64_t b) { int64_t r; return LeastCommonMultiple(a, b, r) ? NULL : &Error::INTEGER_OVERFLOW; }
+	};
+	struct SqrtOp {
+		static inline int64_t Apply(int64_t a, int64_t) { return a < 0 ? 0 : (int64_t)SquareRoot((uint64_t)a); }
+		static inline int64_t Flag(int64_t a, int64_t, int64_t) { return a; }
+		static inline const Error* Check(int64_t a, int64_t) { return a < 0 ? &Error::NEGATIVE_SQUARE_ROOT : NULL; }
+	};
+	struct EqualsOp { static inline uint8_t Apply(int64_t a, int64_t b) { return a == b; } };
+	struct NotEqualsOp { static inline uint8_t Apply(int64_t a, int64_t b) { return a != b; } };
+	struct GreaterThanOp { static inline uint8_t Apply(int64_t a, int64_t b) { return a > b; } };
+	struct GreaterThanOrEqualsOp { static inline uint8_t Apply(int64_t a, int64_t b) { return a >= b; } };
+	struct LessThanOp { static inline uint8_t Apply(int64_t a, int64_t b) { return a < b; } };
+	struct LessThanOrEqualsOp { static inline uint8_t Apply(int64_t a, int64_t b) { return a <= b; } };
+
+	static const size_t CHUNK_LENGTH = 256;
+	static const int TAG_FIELD = 1;
+	static uint16_t TAG;
+};
+
+uint16_t IntegerArray::TAG = 0;
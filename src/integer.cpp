@@ -1,8 +1,10 @@
-class Integer : public node::ObjectWrap {
+class Integer {
+	friend class Decimal;
 public:
 
 	static v8::Local<v8::FunctionTemplate> Init(v8::Isolate* isolate, v8::Local<v8::External> data) {
 		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, New, "Integer");
+		t->InstanceTemplate()->SetInternalFieldCount(INT64_FIELD_COUNT);
 		SetPrototypeGetter(isolate, data, t, "low", Low);
 		SetPrototypeGetter(isolate, data, t, "high", High);
 		SetPrototypeMethod(isolate, data, t, "add", Add);
@@ -10,6 +12,13 @@ public:
 		SetPrototypeMethod(isolate, data, t, "multiply", Multiply);
 		SetPrototypeMethod(isolate, data, t, "divide", Divide);
 		SetPrototypeMethod(isolate, data, t, "modulo", Modulo);
+		SetPrototypeMethod(isolate, data, t, "mulDiv", MulDiv);
+		SetPrototypeMethod(isolate, data, t, "mulMod", MulMod);
+		SetPrototypeMethod(isolate, data, t, "pow", Pow);
+		SetPrototypeMethod(isolate, data, t, "powMod", PowMod);
+		SetPrototypeMethod(isolate, data, t, "gcd", Gcd);
+		SetPrototypeMethod(isolate, data, t, "lcm", Lcm);
+		SetPrototypeMethod(isolate, data, t, "sqrt", Sqrt);
 		SetPrototypeMethod(isolate, data, t, "negate", Negate);
 		SetPrototypeMethod(isolate, data, t, "abs", Abs);
 		SetPrototypeMethod(isolate, data, t, "and", And);
@@ -34,32 +43,41 @@ public:
 		SetPrototypeMethod(isolate, data, t, "isNonZero", IsNonZero);
 		SetPrototypeMethod(isolate, data, t, "isSafe", IsSafe);
 		SetPrototypeMethod(isolate, data, t, "isUnsafe", IsUnsafe);
+		SetPrototypeMethod(isolate, data, t, "hash", Hash);
 		SetPrototypeMethod(isolate, data, t, "toNumberUnsafe", ToNumberUnsafe);
 		SetPrototypeMethod(isolate, data, t, "toString", ToString);
 		SetPrototypeMethod(isolate, data, t, "valueOf", ValueOf);
+		SetPrototypeMethod(isolate, data, t, "toBigInt", ToBigInt);
+		SetPrototypeMethod(isolate, data, t, "writeTo", WriteTo);
+		SetPrototypeMethod(isolate, data, t, "writeVarint", WriteVarint);
 		SetStaticMethod(isolate, data, t, "fromString", FromString);
 		SetStaticMethod(isolate, data, t, "fromNumber", FromNumber);
+		SetStaticMethod(isolate, data, t, "fromBigInt", FromBigInt);
+		SetStaticMethod(isolate, data, t, "tryFromString", TryFromString);
+		SetStaticMethod(isolate, data, t, "tryFromNumber", TryFromNumber);
+		SetStaticMethod(isolate, data, t, "tryFromBigInt", TryFromBigInt);
 		SetStaticMethod(isolate, data, t, "fromBits", FromBits);
+		SetStaticMethod(isolate, data, t, "fromBuffer", FromBuffer);
+		SetStaticMethod(isolate, data, t, "fromVarint", FromVarint);
+		SetStaticMethod(isolate, data, t, "varintLength", VarintLength);
 		SetStaticMethod(isolate, data, t, "isInstance", IsInstance);
+		SetStaticMethod(isolate, data, t, "writeText", WriteText);
+#ifdef INTEGER_STATS
+		SetStaticMethod(isolate, data, t, "stats", GetStats);
+		SetStaticMethod(isolate, data, t, "resetStats", ResetStats);
+#endif
 		return t;
 	}
 
 private:
-	explicit Integer(int64_t _value) : node::ObjectWrap(), value(_value) {}
 
 	NODE_METHOD(New) {
 		if (info.IsConstructCall()) {
-			UseAddon;
-			if (!addon->controller.privileges) {
-				return ThrowTypeError(info, "Disabled constructor (use fromString, fromNumber, or fromBits)");
-			}
-			addon->controller.privileges = false;
-			(new Integer(addon->controller.value))->Wrap(info.This());
-			return info.GetReturnValue().Set(info.This());
+			return ThrowTypeError(info, "Disabled constructor (use fromString, fromNumber, or fromBits)");
 		}
 		if (info.Length() == 0) return ReturnNew(info, 0);
+		if (HasInstance(info[0])) return info.GetReturnValue().Set(info[0]);
 		Result cast = Cast(info, info[0]);
-		// TODO: ideally if info[0] is an Integer, that same object is returned.
 		cast.error ? ThrowException(info, *cast.error) : ReturnNew(info, cast.Checked());
 	}
 
@@ -71,19 +89,57 @@ private:
 		ReturnNew(info, (int64_t)((((uint64_t)((uint32_t)high)) << 32) | (uint32_t)low));
 	}
 
+	NODE_METHOD(FromBuffer) {
+		BinaryOptions options;
+		BufferArgument buffer;
+		if (!ParseBinaryOptions(info, 2, options) || !buffer.Parse(info, 0)) return;
+		if (buffer.Available() < FIXED_LENGTH) return ThrowRangeError(info, "The buffer is too small");
+		ReturnNew(info, (int64_t)DecodeFixed(buffer.data + buffer.offset, options.big_endian));
+	}
+
+	NODE_METHOD(FromVarint) {
+		BinaryOptions options;
+		BufferArgument buffer;
+		if (!ParseBinaryOptions(info, 2, options) || !buffer.Parse(info, 0)) return;
+		uint64_t value;
+		if (!DecodeVarint(buffer.data + buffer.offset, buffer.Available(), value)) {
+			return ThrowRangeError(info, VarintError(buffer.data + buffer.offset, buffer.Available()));
+		}
+		ReturnNew(info, options.zigzag ? ZigZagDecode(value) : (int64_t)value);
+	}
+
+	// Returns the number of bytes taken by the varint at the given offset, so
+	// that parsers can advance past the value read by fromVarint().
+	NODE_METHOD(VarintLength) {
+		BufferArgument buffer;
+		if (!buffer.Parse(info, 0)) return;
+		uint64_t value;
+		size_t length = DecodeVarint(buffer.data + buffer.offset, buffer.Available(), value);
+		if (!length) return ThrowRangeError(info, VarintError(buffer.data + buffer.offset, buffer.Available()));
+		Return(info, (uint32_t)length);
+	}
+
 	NODE_METHOD(FromNumber) {
 		REQUIRE_ARGUMENT_NUMBER(first, v8::Local<v8::Number> number);
 		Result cast = Cast(number);
 		if (!cast.error) return ReturnNew(info, cast.Checked());
 		if (info.Length() == 1) return ThrowException(info, *cast.error);
 		v8::Local<v8::Value> defValue = info[1];
-		if (HasInstance(info, defValue)) return info.GetReturnValue().Set(defValue);
+		if (HasInstance(defValue)) return info.GetReturnValue().Set(defValue);
 		if (!defValue->IsNumber()) return ThrowTypeError(info, "Expected the default value to be a number or Integer");
 		Result def = Cast(v8::Local<v8::Number>::Cast(defValue));
 		if (!def.error) return ReturnNew(info, def.Checked());
 		ThrowTypeError(info, "The default value could not be converted to an Integer");
 	}
 
+	// BigInts are read directly (never through a string), so every BigInt
+	// within 64 bits converts exactly, and anything larger throws.
+	NODE_METHOD(FromBigInt) {
+		REQUIRE_ARGUMENT_BIGINT(first, v8::Local<v8::BigInt> bigint);
+		Result cast = Cast(bigint);
+		cast.error ? ThrowException(info, *cast.error) : ReturnNew(info, cast.Checked());
+	}
+
 	NODE_METHOD(FromString) {
 		REQUIRE_ARGUMENT_STRING(first, v8::Local<v8::String> string);
 		uint32_t radix = 10;
@@ -95,17 +151,115 @@ private:
 		if (!cast.error) return ReturnNew(info, cast.Checked());
 		if (info.Length() < 3) return ThrowException(info, *cast.error);
 		v8::Local<v8::Value> defValue = info[2];
-		if (HasInstance(info, defValue)) return info.GetReturnValue().Set(defValue);
+		if (HasInstance(defValue)) return info.GetReturnValue().Set(defValue);
 		if (!defValue->IsString()) return ThrowTypeError(info, "Expected the default value to be a string or Integer");
 		Result def = Cast(info, v8::Local<v8::String>::Cast(defValue), (uint8_t)radix);
 		if (!def.error) return ReturnNew(info, def.Checked());
 		ThrowTypeError(info, "The default value could not be converted to an Integer");
 	}
 
+	// Like fromNumber() and fromString(), except that null is returned if the
+	// value cannot be converted, which is much cheaper than catching an error.
+	// Invalid arguments still throw.
+	NODE_METHOD(TryFromNumber) {
+		REQUIRE_ARGUMENT_NUMBER(first, v8::Local<v8::Number> number);
+		Result cast = Cast(number);
+		if (cast.error) return info.GetReturnValue().SetNull();
+		ReturnNew(info, cast.Checked());
+	}
+
+	NODE_METHOD(TryFromBigInt) {
+		REQUIRE_ARGUMENT_BIGINT(first, v8::Local<v8::BigInt> bigint);
+		Result cast = Cast(bigint);
+		if (cast.error) return info.GetReturnValue().SetNull();
+		ReturnNew(info, cast.Checked());
+	}
+
+	NODE_METHOD(TryFromString) {
+		REQUIRE_ARGUMENT_STRING(first, v8::Local<v8::String> string);
+		uint32_t radix = 10;
+		if (info.Length() > 1) {
+			REQUIRE_ARGUMENT_UINT32(second, radix);
+			if (radix < 2 || radix > 36) return ThrowRangeError(info, "Radix argument must be within 2 - 36");
+		}
+		Result cast = Cast(info, string, (uint8_t)radix);
+		if (cast.error) return info.GetReturnValue().SetNull();
+		ReturnNew(info, cast.Checked());
+	}
+
 	NODE_METHOD(IsInstance) {
-		Return(info, info.Length() != 0 && HasInstance(info, info[0]));
+		Return(info, info.Length() != 0 && HasInstance(info[0]));
 	}
 
+	NODE_METHOD(WriteText) {
+		if (info.Length() == 0 || !(info[0]->IsArray() || info[0]->IsBigInt64Array())) {
+			return ThrowTypeError(info, "Expected first argument to be an array or BigInt64Array");
+		}
+		TextWriter writer;
+		if (info[0]->IsBigInt64Array()) {
+			v8::Local<v8::BigInt64Array> array = v8::Local<v8::BigInt64Array>::Cast(info[0]);
+			const int64_t* elements = Int64Data(array);
+			if (!writer.Open(info, 1)) return;
+			for (size_t i = 0, length = array->Length(); i < length; ++i) {
+				if (!writer.Write(elements[i])) return ThrowRangeError(info, "The buffer is too small");
+			}
+		} else {
+			// Reading the array can run arbitrary getters, so it happens before
+			// anything is known about the buffer.
+			v8::Local<v8::Context> ctx = info.GetIsolate()->GetCurrentContext();
+			v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(info[0]);
+			std::vector<int64_t> values(array->Length());
+			for (uint32_t i = 0; i < values.size(); ++i) {
+				v8::Local<v8::Value> value;
+				if (!array->Get(ctx, i).ToLocal(&value)) return;
+				Result cast = Cast(info, value);
+				if (cast.error) return ThrowException(info, *cast.error);
+				values[i] = cast.Checked();
+			}
+			if (!writer.Open(info, 1)) return;
+			for (int64_t value : values) {
+				if (!writer.Write(value)) return ThrowRangeError(info, "The buffer is too small");
+			}
+		}
+		Return(info, (double)writer.Offset());
+	}
+
+#ifdef INTEGER_STATS
+	// Returns a snapshot of the counters as plain objects of numbers, which
+	// can be serialized as is. Only methods that were called are listed.
+	NODE_METHOD(GetStats) { UseAddon;
+		static const char* const CAST_NAMES[] = { "int32", "double", "integer", "string", "bigint", "invalid" };
+		static const char* const ERROR_NAMES[] = { "overflow", "divideByZero", "conversion", "otherRangeError", "otherTypeError" };
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		const Stats& stats = addon->stats;
+		auto Set = [&](v8::Local<v8::Object> object, const char* key, uint64_t count) {
+			object->CreateDataProperty(ctx, InternalizedFromLatin1(isolate, key), v8::Number::New(isolate, (double)count)).FromJust();
+		};
+		v8::Local<v8::Object> calls = v8::Object::New(isolate);
+		for (const std::unique_ptr<Stats::CallSite>& site : stats.sites) {
+			if (site->calls) Set(calls, site->name.c_str(), site->calls);
+		}
+		v8::Local<v8::Object> integers = v8::Object::New(isolate);
+		Set(integers, "created", stats.created);
+		Set(integers, "reused", stats.reused);
+		v8::Local<v8::Object> casts = v8::Object::New(isolate);
+		for (int i = 0; i < Stats::CAST_KINDS; ++i) Set(casts, CAST_NAMES[i], stats.casts[i]);
+		v8::Local<v8::Object> errors = v8::Object::New(isolate);
+		for (int i = 0; i < Stats::ERROR_KINDS; ++i) Set(errors, ERROR_NAMES[i], stats.errors[i]);
+		v8::Local<v8::Object> result = v8::Object::New(isolate);
+		result->CreateDataProperty(ctx, InternalizedFromLatin1(isolate, "calls"), calls).FromJust();
+		result->CreateDataProperty(ctx, InternalizedFromLatin1(isolate, "integers"), integers).FromJust();
+		result->CreateDataProperty(ctx, InternalizedFromLatin1(isolate, "casts"), casts).FromJust();
+		result->CreateDataProperty(ctx, InternalizedFromLatin1(isolate, "errors"), errors).FromJust();
+		info.GetReturnValue().Set(result);
+	}
+
+	NODE_METHOD(ResetStats) { UseAddon;
+		addon->stats.Reset();
+	}
+#endif
+
 	NODE_GETTER(Low) { UseValue;
 		Return(info, (int32_t)((uint32_t)(((uint64_t)value) & U32_in_U64)));
 	}
@@ -115,70 +269,132 @@ private:
 	}
 
 	NODE_METHOD(Add) { UseValue; UseArgument;
-		if ((arg > 0 && value > MAX_VALUE - arg) || (arg < 0 && value < MIN_VALUE - arg))
-			return ThrowRangeError(info, "Integer overflow");
-		ReturnNew(info, value + arg);
+		if (AddOverflows(value, arg)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value + arg);
 	}
 
 	NODE_METHOD(Subtract) { UseValue; UseArgument;
-		if ((arg < 0 && value > MAX_VALUE + arg) || (arg > 0 && value < MIN_VALUE + arg))
-			return ThrowRangeError(info, "Integer overflow");
-		ReturnNew(info, value - arg);
+		if (SubtractOverflows(value, arg)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value - arg);
 	}
 
 	NODE_METHOD(Multiply) { UseValue; UseArgument;
-		if (value > 0
-			? (arg > 0 ? value > MAX_VALUE / arg : arg < MIN_VALUE / value)
-			: (arg > 0 ? value < MIN_VALUE / arg : (value != 0 && arg < MAX_VALUE / value)))
-			return ThrowRangeError(info, "Integer overflow");
-		ReturnNew(info, value * arg);
+		if (MultiplyOverflows(value, arg)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value * arg);
 	}
 
 	NODE_METHOD(Divide) { UseValue; UseArgument;
-		if (arg == 0) return ThrowRangeError(info, "Divide by zero");
-		if (arg == -1 && value == MIN_VALUE) return ThrowRangeError(info, "Integer overflow");
-		ReturnNew(info, value / arg);
+		if (arg == 0) return ThrowException(info, Error::DIVIDE_BY_ZERO);
+		if (DivideOverflows(value, arg)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value / arg);
 	}
 
 	NODE_METHOD(Modulo) { UseValue; UseArgument;
-		if (arg == 0) return ThrowRangeError(info, "Divide by zero");
-		ReturnNew(info, arg == -1 ? 0 : value % arg);
+		if (arg == 0) return ThrowException(info, Error::DIVIDE_BY_ZERO);
+		ReturnResult(info, value, arg == -1 ? 0 : value % arg);
+	}
+
+	// The operations below only fail if their final result does not fit, since
+	// their intermediate products have 128 bits. Signs are handled separately
+	// from the magnitudes, so that MIN_VALUE needs no special case.
+	NODE_METHOD(MulDiv) { UseValue; UseArgument;
+		int64_t divisor;
+		Rounding rounding;
+		if (!UseArgumentAt(info, 1, divisor) || !ParseRounding(info, 2, rounding)) return;
+		if (divisor == 0) return ThrowException(info, Error::DIVIDE_BY_ZERO);
+		const bool is_negative = ((value < 0) != (arg < 0)) != (divisor < 0);
+		int64_t result;
+		if (!DivideRounded(MultiplyFull(Magnitude(value), Magnitude(arg)), Magnitude(divisor), is_negative, rounding, result)) {
+			return ThrowException(info, Error::INTEGER_OVERFLOW);
+		}
+		ReturnResult(info, value, result);
+	}
+
+	// Like modulo(), the result has the sign of the product.
+	NODE_METHOD(MulMod) { UseValue; UseArgument;
+		int64_t modulus;
+		if (!UseArgumentAt(info, 1, modulus)) return;
+		if (modulus == 0) return ThrowException(info, Error::DIVIDE_BY_ZERO);
+		uint64_t remainder = RemainderFull(MultiplyFull(Magnitude(value), Magnitude(arg)), Magnitude(modulus));
+		ReturnResult(info, value, (value < 0) != (arg < 0) ? -(int64_t)remainder : (int64_t)remainder);
+	}
+
+	NODE_METHOD(Pow) { UseValue; UseArgument;
+		if (arg < 0) return ThrowRangeError(info, "Exponent must be non-negative");
+		int64_t result;
+		if (!Power(value, arg, result)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, result);
+	}
+
+	// Like modulo(), the result has the sign of the power.
+	NODE_METHOD(PowMod) { UseValue; UseArgument;
+		int64_t modulus;
+		if (!UseArgumentAt(info, 1, modulus)) return;
+		if (arg < 0) return ThrowRangeError(info, "Exponent must be non-negative");
+		if (modulus == 0) return ThrowException(info, Error::DIVIDE_BY_ZERO);
+		const uint64_t m = Magnitude(modulus);
+		uint64_t base = Magnitude(value) % m;
+		uint64_t result = 1 % m;
+		for (uint64_t exponent = (uint64_t)arg; exponent; exponent >>= 1) {
+			if (exponent & 1) result = RemainderFull(MultiplyFull(result, base), m);
+			base = RemainderFull(MultiplyFull(base, base), m);
+		}
+		ReturnResult(info, value, value < 0 && (arg & 1) ? -(int64_t)result : (int64_t)result);
+	}
+
+	// The result is never negative, so it only overflows when it is 2^63.
+	NODE_METHOD(Gcd) { UseValue; UseArgument;
+		uint64_t result = GreatestCommonDivisor(Magnitude(value), Magnitude(arg));
+		if (result > (uint64_t)MAX_VALUE) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, (int64_t)result);
+	}
+
+	NODE_METHOD(Lcm) { UseValue; UseArgument;
+		int64_t result;
+		if (!LeastCommonMultiple(value, arg, result)) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, result);
+	}
+
+	// Returns the largest integer whose square is not greater than the value.
+	NODE_METHOD(Sqrt) { UseValue;
+		if (value < 0) return ThrowException(info, Error::NEGATIVE_SQUARE_ROOT);
+		ReturnResult(info, value, (int64_t)SquareRoot((uint64_t)value));
 	}
 
 	NODE_METHOD(Negate) { UseValue;
-		if (value == MIN_VALUE) return ThrowRangeError(info, "Integer overflow");
-		ReturnNew(info, -value);
+		if (value == MIN_VALUE) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, -value);
 	}
 
 	NODE_METHOD(Abs) { UseValue;
-		if (value == MIN_VALUE) return ThrowRangeError(info, "Integer overflow");
-		ReturnNew(info, value >= 0 ? value : -value);
+		if (value == MIN_VALUE) return ThrowException(info, Error::INTEGER_OVERFLOW);
+		ReturnResult(info, value, value >= 0 ? value : -value);
 	}
 
 	NODE_METHOD(And) { UseValue; UseArgument;
-		ReturnNew(info, value & arg);
+		ReturnResult(info, value, value & arg);
 	}
 
 	NODE_METHOD(Or) { UseValue; UseArgument;
-		ReturnNew(info, value | arg);
+		ReturnResult(info, value, value | arg);
 	}
 
 	NODE_METHOD(Xor) { UseValue; UseArgument;
-		ReturnNew(info, value ^ arg);
+		ReturnResult(info, value, value ^ arg);
 	}
 
 	NODE_METHOD(Not) { UseValue;
-		ReturnNew(info, ~value);
+		ReturnResult(info, value, ~value);
 	}
 
 	NODE_METHOD(ShiftLeft) { UseValue;
 		REQUIRE_ARGUMENT_UINT32(first, uint32_t shift);
-		ReturnNew(info, (int64_t)((uint64_t)value << (shift & 63)));
+		ReturnResult(info, value, (int64_t)((uint64_t)value << (shift & 63)));
 	}
 
 	NODE_METHOD(ShiftRight) { UseValue;
 		REQUIRE_ARGUMENT_UINT32(first, uint32_t shift);
-		ReturnNew(info, value >> (shift & 63));
+		ReturnResult(info, value, value >> (shift & 63));
 	}
 
 	NODE_METHOD(Equals) { UseValue; UseArgument;
@@ -252,6 +468,10 @@ private:
 		Return(info, value > MAX_SAFE || value < MIN_SAFE);
 	}
 
+	NODE_METHOD(Hash) { UseValue;
+		Return(info, (int32_t)(uint32_t)Mix((uint64_t)value));
+	}
+
 	NODE_METHOD(ToNumberUnsafe) { UseValue;
 		Return(info, (double)value);
 	}
@@ -263,7 +483,12 @@ private:
 			if (radix < 2 || radix > 36) return ThrowRangeError(info, "Radix argument must be within 2 - 36");
 		}
 		char buffer[STRING_BUFFER_LENGTH];
-		info.GetReturnValue().Set(StringFromLatin1(info.GetIsolate(), WriteString(buffer, value, (uint8_t)radix)));
+		char* string = WriteString(buffer, value, (uint8_t)radix);
+		info.GetReturnValue().Set(StringFromLatin1(info.GetIsolate(), string, (int)(buffer + STRING_BUFFER_LENGTH - 1 - string)));
+	}
+
+	NODE_METHOD(ToBigInt) { UseValue;
+		info.GetReturnValue().Set(v8::BigInt::New(info.GetIsolate(), value));
 	}
 
 	NODE_METHOD(ValueOf) { UseValue;
@@ -275,8 +500,46 @@ private:
 		ThrowRangeError(info, message.c_str());
 	}
 
-	static inline bool HasInstance(NODE_ARGUMENTS info, v8::Local<v8::Value> value) { UseAddon;
-		return v8::Local<v8::FunctionTemplate>::New(info.GetIsolate(), addon->constructorTemplate)->HasInstance(value);
+	NODE_METHOD(WriteTo) { UseValue;
+		BinaryOptions options;
+		BufferArgument buffer;
+		if (!ParseBinaryOptions(info, 2, options) || !buffer.Parse(info, 0)) return;
+		if (buffer.Available() < FIXED_LENGTH) return ThrowRangeError(info, "The buffer is too small");
+		EncodeFixed(buffer.data + buffer.offset, (uint64_t)value, options.big_endian);
+		Return(info, (double)(buffer.offset + FIXED_LENGTH));
+	}
+
+	NODE_METHOD(WriteVarint) { UseValue;
+		BinaryOptions options;
+		BufferArgument buffer;
+		if (!ParseBinaryOptions(info, 2, options) || !buffer.Parse(info, 0)) return;
+		uint64_t encoded = options.zigzag ? ZigZagEncode(value) : (uint64_t)value;
+		if (buffer.Available() < VarintSize(encoded)) return ThrowRangeError(info, "The buffer is too small");
+		uint8_t* end = EncodeVarint(buffer.data + buffer.offset, encoded);
+		Return(info, (double)(end - buffer.data));
+	}
+
+public:
+	// Integers are recognized by the tag in their first internal field, which
+	// only they point to. This takes constant time (unlike checking the template
+	// chain with FunctionTemplate::HasInstance) and does not need the addon.
+	static inline bool HasInstance(v8::Local<v8::Value> value) {
+		if (!value->IsObject()) return false;
+		v8::Local<v8::Object> object = v8::Local<v8::Object>::Cast(value);
+		if (object->InternalFieldCount() != INT64_FIELD_COUNT) return false;
+		void* tag = GetTagFromInternalField(object, 0);
+		return tag == &TAGS[0] || tag == &TAGS[1];
+	}
+
+	// The finalizer of MurmurHash3, which mixes every bit of the input into
+	// every bit of the output (so that any subset of them can be used).
+	static inline uint64_t Mix(uint64_t x) {
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return x;
 	}
 
 	static inline void Return(NODE_GETTER_ARGUMENTS info, int32_t value) { info.GetReturnValue().Set(value); }
@@ -285,40 +548,286 @@ private:
 	static inline void Return(NODE_ARGUMENTS info, double value) { info.GetReturnValue().Set(value); }
 	static inline void Return(NODE_ARGUMENTS info, bool value) { info.GetReturnValue().Set(value); }
 
-	static inline void ReturnNew(NODE_ARGUMENTS info, int64_t value) { UseAddon;
+	// Writes base-10 values, separated by a separator, into a Uint8Array. The
+	// arguments are (buffer, [offset, [separator]]), starting at the given one.
+	class TextWriter {
+	public:
+		bool Open(NODE_ARGUMENTS info, int at) {
+			if (info.Length() > at + 2 && !info[at + 2]->IsString()) {
+				ThrowTypeError(info, "Expected the separator to be a string");
+				return false;
+			}
+			if (!buffer.Parse(info, at)) return false;
+			separator[0] = ',';
+			separator_length = 1;
+			if (info.Length() > at + 2) {
+				v8::Local<v8::String> string = v8::Local<v8::String>::Cast(info[at + 2]);
+				separator_length = (size_t)string->Utf8Length(info.GetIsolate());
+				if (separator_length > sizeof(separator)) {
+					ThrowRangeError(info, "The separator must be at most 16 bytes");
+					return false;
+				}
+				string->WriteUtf8(info.GetIsolate(), separator, (int)separator_length, NULL, v8::String::NO_NULL_TERMINATION);
+			}
+			first = true;
+			return true;
+		}
+
+		// Returns false (without writing anything) if the value does not fit.
+		inline bool Write(int64_t value) {
+			bool is_negative = value < 0;
+			uint64_t x = (uint64_t)(value ^ -is_negative) + is_negative;
+			size_t prefix = (first ? 0 : separator_length) + is_negative;
+			size_t length = prefix + (size_t)DecimalLength(x);
+			if (length > buffer.Available()) return false;
+			char* slot = reinterpret_cast<char*>(buffer.data + buffer.offset);
+			if (!first) memcpy(slot, separator, separator_length);
+			if (is_negative) slot[prefix - 1] = '-';
+			WriteDecimal(slot + length, x);
+			buffer.offset += length;
+			first = false;
+			return true;
+		}
+
+		inline size_t Offset() const { return buffer.offset; }
+
+	private:
+		BufferArgument buffer;
+		char separator[16];
+		size_t separator_length;
+		bool first;
+	};
+
+	// Since Integers are immutable, commonly used values are only created once
+	// per environment and then shared by every operation that produces them.
+	static inline v8::MaybeLocal<v8::Object> NewInstance(NODE_ARGUMENTS info, int64_t value) { UseAddon;
+		return NewInstance(info.GetIsolate(), addon, value);
+	}
+
+	static inline v8::MaybeLocal<v8::Object> NewInstance(v8::Isolate* isolate, Addon* addon, int64_t value) {
+		size_t slot = CacheSlot(value);
+		if (slot != CACHE_LENGTH && !addon->cache[slot].IsEmpty()) {
+#ifdef INTEGER_STATS
+			++addon->stats.reused;
+#endif
+			return v8::Local<v8::Object>::New(isolate, addon->cache[slot]);
+		}
+#ifdef INTEGER_STATS
+		++addon->stats.created;
+#endif
+		// Cloning a blank instance (instead of calling the constructor) creates
+		// an object of the same class without entering New or the template.
+		v8::Local<v8::Object> object = v8::Local<v8::Object>::New(isolate, addon->blank)->Clone();
+		SetInt64(object, TAGS, value);
+		if (slot != CACHE_LENGTH) addon->cache[slot].Reset(isolate, object);
+		return object;
+	}
+
+	static inline void ReturnNew(NODE_ARGUMENTS info, int64_t value) {
+		info.GetReturnValue().Set(NewInstance(info, value).ToLocalChecked());
+	}
+
+	// Like UseArgument, for the operands after the first.
+	static bool UseArgumentAt(NODE_ARGUMENTS info, int at, int64_t& arg) {
+		if (info.Length() <= at) {
+			ThrowTypeError(info, "Missing argument");
+			return false;
+		}
+		Result cast = Cast(info, info[at]);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		arg = cast.Checked();
+		return true;
+	}
+
+	// The rounding modes have the same names as in Intl.NumberFormat.
+	enum Rounding { TRUNC, FLOOR, CEIL, EXPAND, HALF_EXPAND, HALF_EVEN };
+
+	static bool ParseRounding(NODE_ARGUMENTS info, int at, Rounding& rounding) {
+		static const char* const NAMES[] = { "trunc", "floor", "ceil", "expand", "halfExpand", "halfEven" };
+		rounding = TRUNC;
+		if (info.Length() <= at || info[at]->IsUndefined()) return true;
 		v8::Isolate* isolate = info.GetIsolate();
-		addon->controller.privileges = true;
-		addon->controller.value = value;
-		info.GetReturnValue().Set(v8::Local<v8::Function>::New(isolate, addon->constructor)->NewInstance(isolate->GetCurrentContext()).ToLocalChecked());
+		for (int i = 0; i <= HALF_EVEN; ++i) {
+			if (info[at]->StrictEquals(InternalizedFromLatin1(isolate, NAMES[i]))) {
+				rounding = (Rounding)i;
+				return true;
+			}
+		}
+		ThrowTypeError(info, "Expected the rounding mode to be \"trunc\", \"floor\", \"ceil\", \"expand\", \"halfExpand\", or \"halfEven\"");
+		return false;
+	}
+
+	// Returns whether a quotient with a non-zero remainder should be rounded
+	// away from zero (quotients are truncated toward zero by default).
+	static inline bool RoundsAway(Rounding rounding, bool is_negative, uint64_t quotient, uint64_t remainder, uint64_t divisor) {
+		switch (rounding) {
+			case TRUNC: return false;
+			case FLOOR: return is_negative;
+			case CEIL: return !is_negative;
+			case EXPAND: return true;
+			case HALF_EXPAND: return remainder >= divisor - remainder;
+			case HALF_EVEN: return remainder > divisor - remainder || (remainder == divisor - remainder && (quotient & 1));
+		}
+		return false;
+	}
+
+	// Divides magnitudes (the divisor must not be zero) and gives the rounded
+	// quotient the sign. Returns false if the result does not fit. If the
+	// dividend was already inexact (it was truncated by an earlier division), a
+	// remainder of exactly half is treated as more than half, which requires
+	// the divisor to be even and less than 2^63.
+	static bool DivideRounded(Uint128 n, uint64_t d, bool is_negative, Rounding rounding, int64_t& result, bool inexact = false) {
+		const uint64_t limit = (uint64_t)MAX_VALUE + is_negative;
+		if (n.high >= d) return false;
+		uint64_t remainder;
+		uint64_t quotient = DivideFull(n, d, remainder);
+		if (quotient > limit) return false;
+		if (remainder || inexact) {
+			if (inexact) remainder = remainder * 2 + 1, d *= 2;
+			if (RoundsAway(rounding, is_negative, quotient, remainder, d) && quotient++ == limit) return false;
+		}
+		result = (int64_t)(is_negative ? 0 - quotient : quotient);
+		return true;
 	}
 
+	// Returns the receiver itself if an operation did not change its value.
+	static inline void ReturnResult(NODE_ARGUMENTS info, int64_t value, int64_t result) {
+		if (result == value) {
+#ifdef INTEGER_STATS
+			++GetAddon(info.Data())->stats.reused;
+#endif
+			return info.GetReturnValue().Set(info.This());
+		}
+		ReturnNew(info, result);
+	}
+
+	static inline size_t CacheSlot(int64_t value) {
+		if (value >= CACHE_MIN && value <= CACHE_MAX) return (size_t)(value - CACHE_MIN);
+		if (value == MIN_VALUE) return CACHE_LENGTH - 2;
+		if (value == MAX_VALUE) return CACHE_LENGTH - 1;
+		return CACHE_LENGTH;
+	}
+
+	// Small integers skip the floating-point checks, and Integers are recognized
+	// by their tag right after the (cheap) check that rules out every number.
 	static Result Cast(NODE_ARGUMENTS info, v8::Local<v8::Value> value) {
-		if (value->IsNumber()) return Cast(v8::Local<v8::Number>::Cast(value));
-		if (value->IsString()) return Cast(info, v8::Local<v8::String>::Cast(value), 10);
-		if (HasInstance(info, value)) return Result(node::ObjectWrap::Unwrap<Integer>(v8::Local<v8::Object>::Cast(value))->value);
-		return Result("Expected a number, string, or Integer");
+		if (value->IsNumber()) {
+			if (value->IsInt32()) {
+				CountCast(info, Stats::CAST_INT32);
+				return Result((int64_t)v8::Local<v8::Int32>::Cast(value)->Value());
+			}
+			CountCast(info, Stats::CAST_DOUBLE);
+			return Cast(v8::Local<v8::Number>::Cast(value));
+		}
+		if (HasInstance(value)) {
+			CountCast(info, Stats::CAST_INTEGER);
+			return Result(GetInt64(v8::Local<v8::Object>::Cast(value)));
+		}
+		if (value->IsString()) {
+			CountCast(info, Stats::CAST_STRING);
+			return Cast(info, v8::Local<v8::String>::Cast(value), 10);
+		}
+		if (value->IsBigInt()) {
+			CountCast(info, Stats::CAST_BIGINT);
+			return Cast(v8::Local<v8::BigInt>::Cast(value));
+		}
+		CountCast(info, Stats::CAST_INVALID);
+		return Result(Error::INVALID_TYPE);
+	}
+
+	static Result Cast(v8::Local<v8::BigInt> bigint) {
+		bool lossless;
+		int64_t value = bigint->Int64Value(&lossless);
+		if (!lossless) return Result(Error::BIGINT_TOO_LARGE);
+		return Result(value);
 	}
 
 	static Result Cast(v8::Local<v8::Number> number) {
 		double value = number->Value();
-		if (!std::isfinite(value) || std::floor(value) != value) return Result("The given number is not an integer");
-		if (value > MAX_SAFE_DOUBLE || value < MIN_SAFE_DOUBLE) return Result("The precision of the given number cannot be guaranteed", true);
+		if (!std::isfinite(value) || std::floor(value) != value) return Result(Error::NOT_AN_INTEGER);
+		if (value > MAX_SAFE_DOUBLE || value < MIN_SAFE_DOUBLE) return Result(Error::UNSAFE_NUMBER);
 		return Result((int64_t)value);
 	}
 
+	// Strings that are short enough to be numbers are copied onto the stack in
+	// their own representation, instead of being converted to UTF-16 on the heap.
 	static Result Cast(NODE_ARGUMENTS info, v8::Local<v8::String> string, uint8_t radix) {
-		auto IsWhitespace = [](uint16_t c) { return c == ' ' || (c <= '\r' && c >= '\t'); };
-
+		int length = string->Length();
+		if (length <= STRING_STACK_LENGTH) {
+			if (string->IsOneByte()) {
+				uint8_t buffer[STRING_STACK_LENGTH];
+				string->WriteOneByte(info.GetIsolate(), buffer, 0, length, v8::String::NO_NULL_TERMINATION);
+				int64_t value;
+				if ((radix == 10 || radix == 16) && ParseDigits(buffer, length, radix, value)) return Result(value);
+				return Parse(buffer, length, radix);
+			}
+			uint16_t buffer[STRING_STACK_LENGTH];
+			string->Write(info.GetIsolate(), buffer, 0, length, v8::String::NO_NULL_TERMINATION);
+			return Parse(buffer, length, radix);
+		}
 		v8::String::Value utf16(info.GetIsolate(), string);
-		const uint16_t* str = *utf16;
-		int len = utf16.length();
+		return Parse(*utf16, utf16.length(), radix);
+	}
+
+	// Parses the common case of an optional minus sign followed by nothing but
+	// decimal or hexadecimal digits, eight at a time. Since that is at most 19
+	// or 16 significant digits, only the final value needs an overflow check.
+	// Anything else (including any error) is left to Parse.
+	static bool ParseDigits(const uint8_t* str, int len, uint8_t radix, int64_t& result) {
+		const uint8_t* end = str + len;
+		bool is_negative = str != end && *str == '-';
+		str += is_negative;
+		if (str == end) return false;
+		while (str != end - 1 && *str == '0') { ++str; }
+		if (end - str > (radix == 10 ? 19 : 16)) return false;
+
+		uint64_t value = 0;
+		if (radix == 10) {
+			for (; end - str >= 8; str += 8) {
+				uint64_t chunk = LoadChunk(str);
+				if (!IsDecimalChunk(chunk)) return false;
+				value = value * 100000000 + ParseDecimalChunk(chunk);
+			}
+			for (; str != end; ++str) {
+				unsigned digit = *str - '0';
+				if (digit > 9) return false;
+				value = value * 10 + digit;
+			}
+		} else {
+			for (; end - str >= 8; str += 8) {
+				uint64_t chunk = LoadChunk(str);
+				if (!IsHexChunk(chunk)) return false;
+				value = (value << 32) | ParseHexChunk(chunk);
+			}
+			for (; str != end; ++str) {
+				unsigned digit = *str - '0';
+				if (digit > 9) {
+					digit = (*str | 0x20) - 'a' + 10;
+					if (digit < 10 || digit > 15) return false;
+				}
+				value = (value << 4) | digit;
+			}
+		}
+
+		if (value > I64_in_U64 + is_negative) return false;
+		result = (is_negative && value) ? -((int64_t)(value - 1)) - 1 : (int64_t)value;
+		return true;
+	}
+
+	template <typename Char>
+	static Result Parse(const Char* str, int len, uint8_t radix) {
+		auto IsWhitespace = [](uint16_t c) { return c == ' ' || (c <= '\r' && c >= '\t'); };
 		int i = 0;
 
 		// Skip leading whitespace.
 		while (i<len && IsWhitespace(str[i])) { ++i; }
-		if (i == len) return Result("The given string does not contain a number");
+		if (i == len) return Result(Error::NO_NUMBER);
 
 		uint64_t value = 0;
+		uint64_t limit = UINT64_MAX / radix;
 		uint8_t max_digit = radix > 10 ? '9' : (radix - 1 + '0');
 		uint8_t max_alpha = radix > 10 ? (radix - 11 + 'a') : 0;
 		uint8_t min_alpha = radix > 10 ? 'a' : 255;
@@ -336,31 +845,39 @@ private:
 				}
 				c -= 39;
 			}
-			uint64_t previous = value;
-			if (previous > (value = value * radix + (c - '0'))) return Result("The given string represents a number that is too large", true);
+			uint64_t digit = c - '0';
+			if (value > limit || (value = value * radix) > UINT64_MAX - digit) return Result(Error::TOO_LARGE);
+			value += digit;
 		}
 
 		// Skip trailing whitespace.
 		while (i<len && IsWhitespace(str[i])) { ++i; }
 
-		if (i != len) return Result("The given string contains non-integer characters");
-		if (value > I64_in_U64 + is_negative) return Result("The given string represents a number that is too large", true);
+		if (i != len) return Result(Error::INVALID_CHARACTERS);
+		if (value > I64_in_U64 + is_negative) return Result(Error::TOO_LARGE);
 		return Result((is_negative && value) ? -((int64_t)(value - 1)) - 1 : (int64_t)value);
 	}
 
 	static char* WriteString(char* buffer, int64_t value, uint8_t radix) {
 		bool is_negative = value < 0;
 		uint64_t x = (uint64_t)(value ^ -is_negative) + is_negative;
-		unsigned char* slot = reinterpret_cast<unsigned char*>(buffer + STRING_BUFFER_LENGTH - 1);
+		char* slot = buffer + STRING_BUFFER_LENGTH - 1;
 		*slot = '\0';
 
-		do {
-			uint64_t digit = x % radix;
-			*(--slot) = digit + '0' + (digit > 9) * 39;
-		} while (x /= radix);
+		if (radix == 10) {
+			slot = WriteDecimal(slot, x);
+		} else if ((radix & (radix - 1)) == 0) {
+			unsigned bits = 1;
+			while ((1u << bits) != radix) { ++bits; }
+			slot = WritePowerOfTwo(slot, x, bits);
+		} else {
+			do {
+				*(--slot) = DIGIT_CHARS[x % radix];
+			} while (x /= radix);
+		}
 
 		*(slot - 1) = '-';
-		return reinterpret_cast<char*>(slot - is_negative);
+		return slot - is_negative;
 	}
 
 	static const int64_t MAX_VALUE = 0x7fffffffffffffffLL;
@@ -372,6 +889,11 @@ private:
 	static constexpr uint64_t I64_in_U64 = (uint64_t)MAX_VALUE;
 	static constexpr uint64_t U32_in_U64 = (uint64_t)0xffffffffLU;
 	static const size_t STRING_BUFFER_LENGTH = 72;
-
-	const int64_t value;
+	static const int STRING_STACK_LENGTH = 128;
+	static const int64_t CACHE_MIN = -128;
+	static const int64_t CACHE_MAX = 1023;
+	static const size_t CACHE_LENGTH = (size_t)(CACHE_MAX - CACHE_MIN + 1) + 2;
+	static Int64Tag TAGS[2];
 };
+
+Int64Tag Integer::TAGS[2] = { { 0, false }, { 0, true } };
@@ -6,11 +6,135 @@
 inline v8::Local<v8::String> StringFromLatin1(v8::Isolate* isolate, const char* data) {
 	return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(data), v8::NewStringType::kNormal).ToLocalChecked();
 }
+inline v8::Local<v8::String> StringFromLatin1(v8::Isolate* isolate, const char* data, int length) {
+	return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(data), v8::NewStringType::kNormal, length).ToLocalChecked();
+}
 inline v8::Local<v8::String> InternalizedFromLatin1(v8::Isolate* isolate, const char* data) {
 	return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(data), v8::NewStringType::kInternalized).ToLocalChecked();
 }
 
+inline void* BufferData(v8::Local<v8::ArrayBuffer> buffer) {
+#if V8_MAJOR_VERSION >= 10
+	return buffer->Data();
+#elif V8_MAJOR_VERSION >= 8
+	return buffer->GetBackingStore()->Data();
+#else
+	return buffer->GetContents().Data();
+#endif
+}
+inline int64_t* Int64Data(v8::Local<v8::BigInt64Array> array) {
+	return reinterpret_cast<int64_t*>(static_cast<char*>(BufferData(array->Buffer())) + array->ByteOffset());
+}
+
+// Creates a zero-filled ArrayBuffer or SharedArrayBuffer, or returns false
+// (without throwing) if the memory cannot be allocated. Buffer::New() would
+// abort the process instead, so lengths chosen by the caller must go through
+// here. The memory is owned by V8 afterwards, just like Node's own buffers.
+template <class Buffer>
+inline bool NewZeroedBuffer(v8::Isolate* isolate, size_t byte_length, v8::Local<Buffer>& buffer) {
+#if V8_MAJOR_VERSION >= 8 && !defined(V8_ENABLE_SANDBOX)
+	void* data = calloc(byte_length ? byte_length : 1, 1);
+	if (!data) return false;
+	std::shared_ptr<v8::BackingStore> store = Buffer::NewBackingStore(data, byte_length, [](void* data, size_t, void*) { free(data); }, NULL);
+	buffer = Buffer::New(isolate, store);
+#elif V8_MAJOR_VERSION >= 8
+	// Memory outside of the sandbox cannot be given to V8.
+	buffer = Buffer::New(isolate, byte_length);
+#else
+	void* data = calloc(byte_length ? byte_length : 1, 1);
+	if (!data) return false;
+	buffer = Buffer::New(isolate, data, byte_length, v8::ArrayBufferCreationMode::kInternalized);
+#endif
+	return true;
+}
+
+// Like NewZeroedBuffer(), with the same length limit as the typed array's
+// constructor.
+template <class Array, class Element>
+inline bool NewTypedArray(v8::Isolate* isolate, size_t length, v8::Local<Array>& array) {
+	v8::Local<v8::ArrayBuffer> buffer;
+	if (length > Array::kMaxLength || !NewZeroedBuffer(isolate, length * sizeof(Element), buffer)) return false;
+	array = Array::New(buffer, 0, length);
+	return true;
+}
+
+// An int64_t is stored directly in an object's internal fields, so that no
+// separate C++ allocation (or weak callback to free it) is needed. V8 requires
+// aligned pointers to have a clear low bit, so each field holds 63 bits (31 on
+// 32-bit platforms) shifted left by one, and the remaining sign bit is carried
+// by the tag in field 0. The tag must point to real memory, since V8 reads the
+// first 16 bits of it while tracing objects that have two or more fields (it
+// checks them for Node's embedder id), so every class has a pair of them.
+struct Int64Tag { const uint16_t reserved; const bool negative; };
+
+static const int INT64_PAYLOAD_BITS = sizeof(void*) * 8 - 1;
+static const int INT64_FIELD_COUNT = 1 + (63 + INT64_PAYLOAD_BITS - 1) / INT64_PAYLOAD_BITS;
+static const uint64_t INT64_PAYLOAD_MASK = ((uint64_t)1 << INT64_PAYLOAD_BITS) - 1;
+
+inline int64_t GetInt64(v8::Local<v8::Object> object) {
+	const Int64Tag* tag = static_cast<const Int64Tag*>(object->GetAlignedPointerFromInternalField(0));
+	uint64_t value = (uint64_t)tag->negative << 63;
+	for (int i = 1; i < INT64_FIELD_COUNT; ++i) {
+		uintptr_t field = reinterpret_cast<uintptr_t>(object->GetAlignedPointerFromInternalField(i));
+		value |= (uint64_t)(field >> 1) << ((i - 1) * INT64_PAYLOAD_BITS);
+	}
+	return (int64_t)value;
+}
+inline void SetInt64(v8::Local<v8::Object> object, Int64Tag* tags, int64_t value) {
+	uint64_t bits = (uint64_t)value;
+	object->SetAlignedPointerInInternalField(0, &tags[bits >> 63]);
+	for (int i = 1; i < INT64_FIELD_COUNT; ++i) {
+		uintptr_t field = (uintptr_t)((bits >> ((i - 1) * INT64_PAYLOAD_BITS)) & INT64_PAYLOAD_MASK) << 1;
+		object->SetAlignedPointerInInternalField(i, reinterpret_cast<void*>(field));
+	}
+}
+
+// Returns the aligned pointer in one of an object's internal fields, or NULL if
+// the field holds a JavaScript value instead (as other classes, including those
+// of other addons, may do). V8 refuses to read those as aligned pointers, but
+// it reads an aligned pointer as a small integer, so the field's tagged value
+// is checked first. Only then can the pointer be compared against a tag.
+inline void* GetTagFromInternalField(v8::Local<v8::Object> object, int index) {
+#if V8_MAJOR_VERSION >= 12
+	v8::Local<v8::Data> field = object->GetInternalField(index);
+	if (!field->IsValue() || !field.As<v8::Value>()->IsInt32()) return NULL;
+#else
+	if (!object->GetInternalField(index)->IsInt32()) return NULL;
+#endif
+	return object->GetAlignedPointerFromInternalField(index);
+}
+
+// Every callback's data refers to the addon (through its call site, when calls
+// are being counted).
+inline Addon* GetAddon(v8::Local<v8::Value> data) {
+#ifdef INTEGER_STATS
+	return static_cast<Stats::CallSite*>(v8::Local<v8::External>::Cast(data)->Value())->addon;
+#else
+	return static_cast<Addon*>(v8::Local<v8::External>::Cast(data)->Value());
+#endif
+}
+
+inline void CountCast(NODE_ARGUMENTS info, Stats::CastKind kind) {
+#ifdef INTEGER_STATS
+	++GetAddon(info.Data())->stats.casts[kind];
+#endif
+}
+
+inline void CountError(NODE_ARGUMENTS info, const Error& error) {
+#ifdef INTEGER_STATS
+	Stats::ErrorKind kind;
+	switch (error.kind) {
+		case Error::KIND_OVERFLOW: kind = Stats::ERROR_OVERFLOW; break;
+		case Error::KIND_DIVIDE_BY_ZERO: kind = Stats::ERROR_DIVIDE_BY_ZERO; break;
+		case Error::KIND_CONVERSION: kind = Stats::ERROR_CONVERSION; break;
+		default: kind = error.Type == v8::Exception::RangeError ? Stats::ERROR_RANGE : Stats::ERROR_TYPE;
+	}
+	++GetAddon(info.Data())->stats.errors[kind];
+#endif
+}
+
 void ThrowException(NODE_ARGUMENTS info, Error error) {
+	CountError(info, error);
 	v8::Isolate* isolate = info.GetIsolate();
 	isolate->ThrowException(error.Type(StringFromLatin1(isolate, error.message)));
 }
@@ -30,6 +154,8 @@ void ThrowRangeError(NODE_ARGUMENTS info, const char* message) { ThrowException(
 	_REQUIRE_ARGUMENT(at, var, Number, a number)
 #define REQUIRE_ARGUMENT_STRING(at, var)\
 	_REQUIRE_ARGUMENT(at, var, String, a string)
+#define REQUIRE_ARGUMENT_BIGINT(at, var)\
+	_REQUIRE_ARGUMENT(at, var, BigInt, a BigInt)
 
 #define first() 0
 #define second() 1
@@ -37,14 +163,99 @@ void ThrowRangeError(NODE_ARGUMENTS info, const char* message) { ThrowException(
 #define fourth() 3
 #define fifth() 4
 
-#define UseAddon Addon* addon = static_cast<Addon*>(v8::Local<v8::External>::Cast(info.Data())->Value())
-#define UseValue int64_t value = node::ObjectWrap::Unwrap<Integer>(info.This())->value
+#define UseAddon Addon* addon = GetAddon(info.Data())
+#define UseValue int64_t value = GetInt64(info.This())
+// The elements must be read after any JS code that the method runs (such as
+// the getters of an options object), since that code could detach them.
+#define UseElements\
+	v8::Local<v8::BigInt64Array> array = IntegerArray::Elements(info.This());\
+	const size_t length = array->Length();\
+	int64_t* elements = Int64Data(array)
 #define UseArgument\
 	if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");\
 	Result cast = Cast(info, info[0]);\
 	if (cast.error) return ThrowException(info, *cast.error);\
 	int64_t arg = cast.Checked()
+#define UseDecimal\
+	int64_t value = GetInt64(info.This());\
+	int value_scale = GetScale(info.This())
+#define UseDecimalArgument\
+	if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");\
+	int64_t arg;\
+	int arg_scale;\
+	if (!CastOperand(info, info[0], arg, arg_scale)) return
+
+// A Buffer or Uint8Array argument, optionally followed by a byte offset into
+// it. The data pointer is only valid until JS code runs again (which could
+// detach the buffer), so every other argument should be read first.
+struct BufferArgument {
+	bool Parse(NODE_ARGUMENTS info, int at) {
+		if (info.Length() <= at || !info[at]->IsUint8Array()) {
+			ThrowTypeError(info, "Expected the buffer to be a Buffer or Uint8Array");
+			return false;
+		}
+		v8::Local<v8::Uint8Array> buffer = v8::Local<v8::Uint8Array>::Cast(info[at]);
+		data = static_cast<uint8_t*>(BufferData(buffer->Buffer())) + buffer->ByteOffset();
+		length = buffer->ByteLength();
+		offset = 0;
+		if (info.Length() > at + 1 && !info[at + 1]->IsUndefined()) {
+			if (!info[at + 1]->IsUint32()) {
+				ThrowTypeError(info, "Expected the offset to be a regular 32-bit unsigned integer");
+				return false;
+			}
+			offset = v8::Local<v8::Uint32>::Cast(info[at + 1])->Value();
+			if (offset > length) {
+				ThrowRangeError(info, "The offset is out of bounds");
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline size_t Available() const { return length - offset; }
 
+	uint8_t* data;
+	size_t length;
+	size_t offset;
+};
+
+#ifdef INTEGER_STATS
+static void CountedMethod(NODE_ARGUMENTS info) {
+	Stats::CallSite* site = static_cast<Stats::CallSite*>(v8::Local<v8::External>::Cast(info.Data())->Value());
+	++site->calls;
+	site->method(info);
+}
+static void CountedGetter(v8::Local<v8::String> property, NODE_GETTER_ARGUMENTS info) {
+	Stats::CallSite* site = static_cast<Stats::CallSite*>(v8::Local<v8::External>::Cast(info.Data())->Value());
+	++site->calls;
+	site->getter(property, info);
+}
+static v8::Local<v8::External> NewCallSite(v8::Isolate* isolate, v8::Local<v8::External> data, const char* separator, const char* name) {
+	Addon* addon = static_cast<Addon*>(data->Value());
+	Stats::CallSite* site = new Stats::CallSite();
+	site->addon = addon;
+	site->name = std::string(addon->stats.current_class) + separator + name;
+	addon->stats.sites.emplace_back(site);
+	return v8::External::New(isolate, site);
+}
+#endif
+
+// When calls are being counted, these replace the callback with a trampoline,
+// and the data with the callback's call site. Otherwise, they do nothing.
+inline void CountCalls(v8::Isolate* isolate, v8::Local<v8::External>& data, v8::FunctionCallback& func, const char* separator, const char* name) {
+#ifdef INTEGER_STATS
+	data = NewCallSite(isolate, data, separator, name);
+	static_cast<Stats::CallSite*>(data->Value())->method = func;
+	func = CountedMethod;
+#endif
+}
+inline void CountCalls(v8::Isolate* isolate, v8::Local<v8::External>& data, v8::AccessorGetterCallback& func, const char* separator, const char* name) {
+#ifdef INTEGER_STATS
+	data = NewCallSite(isolate, data, separator, name);
+	static_cast<Stats::CallSite*>(data->Value())->getter = func;
+	func = CountedGetter;
+#endif
+}
 
 v8::Local<v8::FunctionTemplate> NewConstructorTemplate(
 	v8::Isolate* isolate,
@@ -52,6 +263,10 @@ v8::Local<v8::FunctionTemplate> NewConstructorTemplate(
 	v8::FunctionCallback func,
 	const char* name
 ) {
+#ifdef INTEGER_STATS
+	static_cast<Addon*>(data->Value())->stats.current_class = name;
+#endif
+	CountCalls(isolate, data, func, "", "");
 	v8::Local<v8::FunctionTemplate> t = v8::FunctionTemplate::New(isolate, func, data);
 	t->InstanceTemplate()->SetInternalFieldCount(1);
 	t->SetClassName(InternalizedFromLatin1(isolate, name));
@@ -65,6 +280,7 @@ void SetStaticMethod(
 	v8::FunctionCallback func
 ) {
 	v8::HandleScope scope(isolate);
+	CountCalls(isolate, data, func, ".", name);
 	recv->Set(
 		InternalizedFromLatin1(isolate, name),
 		v8::FunctionTemplate::New(isolate, func, data)
@@ -78,6 +294,7 @@ void SetPrototypeMethod(
 	v8::FunctionCallback func
 ) {
 	v8::HandleScope scope(isolate);
+	CountCalls(isolate, data, func, "#", name);
 	recv->PrototypeTemplate()->Set(
 		InternalizedFromLatin1(isolate, name),
 		v8::FunctionTemplate::New(isolate, func, data, v8::Signature::New(isolate, recv))
@@ -91,6 +308,7 @@ void SetPrototypeGetter(
 	v8::AccessorGetterCallback func
 ) {
 	v8::HandleScope scope(isolate);
+	CountCalls(isolate, data, func, "#", name);
 	recv->InstanceTemplate()->SetAccessor(
 		InternalizedFromLatin1(isolate, name),
 		func,
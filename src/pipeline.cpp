@@ -0,0 +1,225 @@
+// A sequence of operations that is parsed once and then applied natively, to
+// a single value or to every element of an array, without creating any
+// intermediate Integers. Each step uses the same kernel (and therefore the same
+// overflow checks) as the corresponding Integer.Array method. The compiled
+// steps are stored in a BigInt64Array, as pairs of (operation, operand).
+class Pipeline {
+public:
+
+	static v8::Local<v8::FunctionTemplate> Init(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, New, "Pipeline");
+		SetPrototypeMethod(isolate, data, t, "apply", Apply);
+		SetPrototypeMethod(isolate, data, t, "applyAll", ApplyAll);
+		return t;
+	}
+
+private:
+
+	typedef const Error* (*StepFunction)(int64_t& value, int64_t operand);
+	typedef size_t (*ChunkFunction)(const int64_t* in, int64_t operand, int64_t* out, size_t length);
+	enum OperandKind { VALUE, SHIFT, EXPONENT, NONE };
+
+	struct Operation {
+		const char* name;
+		StepFunction step;
+		ChunkFunction chunk;
+		OperandKind kind;
+		int64_t fixed;
+	};
+
+	template <class Op>
+	static const Error* Step(int64_t& value, int64_t operand) {
+		const Error* error = Op::Check(value, operand);
+		if (!error) value = Op::Apply(value, operand);
+		return error;
+	}
+
+	template <class Op>
+	static size_t Chunk(const int64_t* in, int64_t operand, int64_t* out, size_t length) {
+		return IntegerArray::Map<Op>(in, IntegerArray::Same(operand), out, length);
+	}
+
+	NODE_METHOD(New) {
+		if (!info.IsConstructCall()) return ThrowTypeError(info, "Class constructor Pipeline cannot be invoked without 'new'");
+		if (info.Length() == 0 || !info[0]->IsArray()) return ThrowTypeError(info, "Expected first argument to be an array of operations");
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+		v8::Local<v8::Array> ops = v8::Local<v8::Array>::Cast(info[0]);
+		uint32_t length = ops->Length();
+		v8::Local<v8::BigInt64Array> program;
+		if (!IntegerArray::Allocate(info, (size_t)length * 2, program)) return;
+		int64_t* steps = Int64Data(program);
+		for (uint32_t i = 0; i < length; ++i) {
+			v8::Local<v8::Value> op;
+			if (!ops->Get(ctx, i).ToLocal(&op)) return;
+			v8::Local<v8::Value> name = op;
+			v8::Local<v8::Value> operand;
+			if (op->IsArray()) {
+				v8::Local<v8::Array> pair = v8::Local<v8::Array>::Cast(op);
+				if (!pair->Get(ctx, 0).ToLocal(&name)) return;
+				if (pair->Length() > 1 && !pair->Get(ctx, 1).ToLocal(&operand)) return;
+			}
+			if (!name->IsString()) return ThrowTypeError(info, "Expected each operation to be a name or a [name, operand] array");
+			size_t index = Find(isolate, v8::Local<v8::String>::Cast(name));
+			if (index == OPERATION_COUNT) {
+				std::string message = "Unknown operation: ";
+				message += *v8::String::Utf8Value(isolate, name);
+				return ThrowTypeError(info, message.c_str());
+			}
+			const Operation& operation = OPERATIONS[index];
+			int64_t value = operation.fixed;
+			if (operation.kind == NONE) {
+				if (!operand.IsEmpty()) return ThrowTypeError(info, "Unexpected operand");
+			} else if (operand.IsEmpty()) {
+				return ThrowTypeError(info, "Missing operand");
+			} else if (operation.kind == SHIFT) {
+				if (!operand->IsUint32()) return ThrowTypeError(info, "Expected the shift to be a regular 32-bit unsigned integer");
+				value = v8::Local<v8::Uint32>::Cast(operand)->Value() & 63;
+			} else {
+				Result cast = Integer::Cast(info, operand);
+				if (cast.error) return ThrowException(info, *cast.error);
+				value = cast.Checked();
+				if (operation.kind == EXPONENT && value < 0) return ThrowRangeError(info, "Exponent must be non-negative");
+			}
+			steps[i * 2] = (int64_t)index;
+			steps[i * 2 + 1] = value;
+		}
+		info.This()->SetInternalField(0, program);
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_METHOD(Apply) {
+		if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");
+		Result cast = Integer::Cast(info, info[0]);
+		if (cast.error) return ThrowException(info, *cast.error);
+		int64_t value = cast.Checked();
+		v8::Local<v8::BigInt64Array> program = Program(info.This());
+		const int64_t* steps = Int64Data(program);
+		for (size_t i = 0, end = program->Length(); i < end; i += 2) {
+			const Error* error = OPERATIONS[steps[i]].step(value, steps[i + 1]);
+			if (error) return ThrowException(info, *error);
+		}
+		Integer::ReturnNew(info, value);
+	}
+
+	// Runs every step over one chunk at a time, so that intermediate results
+	// stay in two small buffers (which fit in L1 cache) instead of arrays.
+	NODE_METHOD(ApplyAll) {
+		if (info.Length() == 0) return ThrowTypeError(info, "Missing argument");
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Value> values = info[0];
+		v8::Local<v8::BigInt64Array> input;
+		v8::Local<v8::BigInt64Array> result;
+		if (values->IsBigInt64Array()) input = v8::Local<v8::BigInt64Array>::Cast(values);
+		else if (IntegerArray::HasInstance(values)) input = IntegerArray::Elements(v8::Local<v8::Object>::Cast(values));
+		else if (values->IsArray()) {
+			v8::Local<v8::Context> ctx = isolate->GetCurrentContext();
+			v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(values);
+			if (!IntegerArray::Allocate(info, array->Length(), result)) return;
+			input = result;
+			int64_t* elements = Int64Data(result);
+			for (uint32_t i = 0, length = array->Length(); i < length; ++i) {
+				v8::Local<v8::Value> element;
+				if (!array->Get(ctx, i).ToLocal(&element)) return;
+				Result cast = Integer::Cast(info, element);
+				if (cast.error) return ThrowException(info, *cast.error);
+				elements[i] = cast.Checked();
+			}
+		} else {
+			return ThrowTypeError(info, "Expected an array, BigInt64Array, or Integer.Array");
+		}
+		const size_t length = input->Length();
+		if (result.IsEmpty() && !IntegerArray::Allocate(info, length, result)) return;
+		v8::Local<v8::BigInt64Array> program = Program(info.This());
+		const int64_t* steps = Int64Data(program);
+		const size_t end = program->Length();
+		const int64_t* in = Int64Data(input);
+		int64_t* out = Int64Data(result);
+		int64_t buffers[2][IntegerArray::CHUNK_LENGTH];
+		for (size_t start = 0; start < length; start += IntegerArray::CHUNK_LENGTH) {
+			size_t count = std::min(length - start, IntegerArray::CHUNK_LENGTH);
+			const int64_t* from = in + start;
+			int64_t* to = buffers[0];
+			bool failed = false;
+			for (size_t i = 0; i < end; i += 2) {
+				failed |= OPERATIONS[steps[i]].chunk(from, steps[i + 1], to, count) != count;
+				from = to;
+				to = buffers[to == buffers[0]];
+			}
+			// The first value to fail is found by running each value through
+			// every step in order, just like apply() would.
+			if (failed) {
+				for (size_t j = 0; j < count; ++j) {
+					int64_t value = in[start + j];
+					for (size_t i = 0; i < end; i += 2) {
+						const Error* error = OPERATIONS[steps[i]].step(value, steps[i + 1]);
+						if (error) return IntegerArray::ThrowAtIndex(info, *error, start + j);
+					}
+				}
+			}
+			memmove(out + start, from, count * sizeof(int64_t));
+		}
+		IntegerArray::Return(info, IntegerArray::NewInstance(info, result));
+	}
+
+	static inline v8::Local<v8::BigInt64Array> Program(v8::Local<v8::Object> object) {
+		return object->GetInternalField(0).As<v8::BigInt64Array>();
+	}
+
+	static size_t Find(v8::Isolate* isolate, v8::Local<v8::String> name) {
+		v8::String::Utf8Value utf8(isolate, name);
+		for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+			if (strcmp(*utf8, OPERATIONS[i].name) == 0) return i;
+		}
+		return OPERATION_COUNT;
+	}
+
+	static const Operation OPERATIONS[];
+	static const size_t OPERATION_COUNT;
+};
+
+#define PIPELINE_OPERATION(name, Op, kind, fixed)\
+	{ name, Pipeline::Step<IntegerArray::Op>, Pipeline::Chunk<IntegerArray::Op>, Pipeline::kind, fixed }
+
+// Every alias defined in lib/index.js is accepted as well.
+const Pipeline::Operation Pipeline::OPERATIONS[] = {
+	PIPELINE_OPERATION("add", AddOp, VALUE, 0),
+	PIPELINE_OPERATION("plus", AddOp, VALUE, 0),
+	PIPELINE_OPERATION("subtract", SubtractOp, VALUE, 0),
+	PIPELINE_OPERATION("minus", SubtractOp, VALUE, 0),
+	PIPELINE_OPERATION("sub", SubtractOp, VALUE, 0),
+	PIPELINE_OPERATION("multiply", MultiplyOp, VALUE, 0),
+	PIPELINE_OPERATION("times", MultiplyOp, VALUE, 0),
+	PIPELINE_OPERATION("mul", MultiplyOp, VALUE, 0),
+	PIPELINE_OPERATION("divide", DivideOp, VALUE, 0),
+	PIPELINE_OPERATION("divideBy", DivideOp, VALUE, 0),
+	PIPELINE_OPERATION("dividedBy", DivideOp, VALUE, 0),
+	PIPELINE_OPERATION("div", DivideOp, VALUE, 0),
+	PIPELINE_OPERATION("over", DivideOp, VALUE, 0),
+	PIPELINE_OPERATION("modulo", ModuloOp, VALUE, 0),
+	PIPELINE_OPERATION("mod", ModuloOp, VALUE, 0),
+	PIPELINE_OPERATION("and", AndOp, VALUE, 0),
+	PIPELINE_OPERATION("or", OrOp, VALUE, 0),
+	PIPELINE_OPERATION("xor", XorOp, VALUE, 0),
+	PIPELINE_OPERATION("shiftLeft", ShiftLeftOp, SHIFT, 0),
+	PIPELINE_OPERATION("shl", ShiftLeftOp, SHIFT, 0),
+	PIPELINE_OPERATION("shiftRight", ShiftRightOp, SHIFT, 0),
+	PIPELINE_OPERATION("shr", ShiftRightOp, SHIFT, 0),
+	PIPELINE_OPERATION("pow", PowOp, EXPONENT, 0),
+	PIPELINE_OPERATION("gcd", GcdOp, VALUE, 0),
+	PIPELINE_OPERATION("lcm", LcmOp, VALUE, 0),
+	// These have no Integer method, and work like Math.min() and Math.max().
+	PIPELINE_OPERATION("min", MinOp, VALUE, 0),
+	PIPELINE_OPERATION("max", MaxOp, VALUE, 0),
+	// Unary operations are expressed as binary ones with a fixed operand.
+	PIPELINE_OPERATION("not", XorOp, NONE, -1),
+	PIPELINE_OPERATION("negate", MultiplyOp, NONE, -1),
+	PIPELINE_OPERATION("neg", MultiplyOp, NONE, -1),
+	PIPELINE_OPERATION("abs", AbsOp, NONE, 0),
+	PIPELINE_OPERATION("absoluteValue", AbsOp, NONE, 0),
+	PIPELINE_OPERATION("sqrt", SqrtOp, NONE, 0),
+};
+
+const size_t Pipeline::OPERATION_COUNT = sizeof(Pipeline::OPERATIONS) / sizeof(Pipeline::OPERATIONS[0]);
+
+#undef PIPELINE_OPERATION
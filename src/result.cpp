@@ -1,18 +1,61 @@
 typedef v8::Local<v8::Value> (*ErrorType)(v8::Local<v8::String>);
 
 struct Error {
-	explicit Error(const char* _message, bool range_error) :
+	// Lets errors be told apart (e.g., by Integer.stats()) without comparing
+	// their messages, which can have an index appended to them.
+	enum Kind { KIND_OTHER, KIND_CONVERSION, KIND_OVERFLOW, KIND_DIVIDE_BY_ZERO };
+
+	explicit Error(const char* _message, bool range_error, Kind _kind = KIND_OTHER, uint8_t _code = 0) :
 		message(_message),
-		Type(range_error ? v8::Exception::RangeError : v8::Exception::TypeError) {}
+		Type(range_error ? v8::Exception::RangeError : v8::Exception::TypeError),
+		kind(_kind),
+		code(_code) {}
+	Error(const char* _message, const Error& other) :
+		message(_message), Type(other.Type), kind(other.kind), code(other.code) {}
 	const char* const message;
 	const ErrorType Type;
+	const Kind kind;
+	const uint8_t code;
+
+	// Every way that converting a value can fail is described once, so that
+	// failing does not allocate anything. The codes are reported by
+	// Integer.parseMany(), so they must never change.
+	static const Error INVALID_TYPE;
+	static const Error NOT_AN_INTEGER;
+	static const Error UNSAFE_NUMBER;
+	static const Error NO_NUMBER;
+	static const Error INVALID_CHARACTERS;
+	static const Error TOO_LARGE;
+	static const Error BIGINT_TOO_LARGE;
+
+	// Decimal strings are never parsed by Integer.parseMany(), so they have no
+	// codes of their own.
+	static const Error INVALID_DECIMAL;
+	static const Error TOO_PRECISE;
+
+	// Arithmetic errors, which the overflow checks of every operation share.
+	static const Error INTEGER_OVERFLOW;
+	static const Error DIVIDE_BY_ZERO;
+	static const Error NEGATIVE_SQUARE_ROOT;
 };
 
+const Error Error::INVALID_TYPE("Expected a number, string, BigInt, or Integer", false, KIND_CONVERSION, 1);
+const Error Error::NOT_AN_INTEGER("The given number is not an integer", false, KIND_CONVERSION, 2);
+const Error Error::UNSAFE_NUMBER("The precision of the given number cannot be guaranteed", true, KIND_CONVERSION, 3);
+const Error Error::NO_NUMBER("The given string does not contain a number", false, KIND_CONVERSION, 4);
+const Error Error::INVALID_CHARACTERS("The given string contains non-integer characters", false, KIND_CONVERSION, 5);
+const Error Error::TOO_LARGE("The given string represents a number that is too large", true, KIND_CONVERSION, 6);
+const Error Error::BIGINT_TOO_LARGE("The given BigInt is too large", true, KIND_CONVERSION, 7);
+const Error Error::INVALID_DECIMAL("The given string contains non-decimal characters", false, KIND_CONVERSION);
+const Error Error::TOO_PRECISE("The given string has more than 18 decimal places", true, KIND_CONVERSION);
+const Error Error::INTEGER_OVERFLOW("Integer overflow", true, KIND_OVERFLOW);
+const Error Error::DIVIDE_BY_ZERO("Divide by zero", true, KIND_DIVIDE_BY_ZERO);
+const Error Error::NEGATIVE_SQUARE_ROOT("Cannot take the square root of a negative number", true);
+
 class Result {
 public:
-	explicit Result(const char* message, bool range_error = false) : error(new Error(message, range_error)) {}
+	explicit Result(const Error& _error) : error(&_error) {}
 	explicit Result(int64_t _value) : error(NULL), value(_value) {}
-	~Result() { delete error; }
 	inline int64_t Checked() { assert(error == NULL); return value; }
 	const Error* const error;
 private:
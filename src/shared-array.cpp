@@ -0,0 +1,154 @@
+// A fixed-length array of 64-bit integers in a SharedArrayBuffer, whose
+// elements are only ever accessed atomically. Each worker wraps the same
+// buffer in its own SharedArray (the buffer getter is what gets posted), so
+// every Integer it returns is created by that worker's own addon instance.
+// Besides the BigInt64Array that keeps the buffer alive, each instance holds a
+// pointer to the elements, which never move.
+class SharedArray {
+public:
+
+	static v8::Local<v8::FunctionTemplate> Init(v8::Isolate* isolate, v8::Local<v8::External> data) {
+		v8::Local<v8::FunctionTemplate> t = NewConstructorTemplate(isolate, data, New, "SharedArray");
+		t->InstanceTemplate()->SetInternalFieldCount(DATA_FIELD + 1);
+		SetPrototypeGetter(isolate, data, t, "length", Length);
+		SetPrototypeGetter(isolate, data, t, "buffer", Buffer);
+		SetPrototypeMethod(isolate, data, t, "load", Load);
+		SetPrototypeMethod(isolate, data, t, "store", Store);
+		SetPrototypeMethod(isolate, data, t, "exchange", Exchange);
+		SetPrototypeMethod(isolate, data, t, "compareExchange", CompareExchange);
+		SetPrototypeMethod(isolate, data, t, "fetchAdd", FetchAdd);
+		SetPrototypeMethod(isolate, data, t, "fetchSub", FetchSub);
+		return t;
+	}
+
+private:
+
+	typedef std::atomic<int64_t> Element;
+	static_assert(sizeof(Element) == sizeof(int64_t), "Expected std::atomic<int64_t> to have no overhead");
+
+	NODE_METHOD(New) {
+		if (!info.IsConstructCall()) return ThrowTypeError(info, "Class constructor SharedArray cannot be invoked without 'new'");
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::SharedArrayBuffer> buffer;
+		size_t byteOffset = 0;
+		size_t length;
+		if (info.Length() == 0 || info[0]->IsUint32()) {
+			length = info.Length() ? v8::Local<v8::Uint32>::Cast(info[0])->Value() : 0;
+			if (length > v8::BigInt64Array::kMaxLength || !NewZeroedBuffer(isolate, length * sizeof(int64_t), buffer)) {
+				return ThrowRangeError(info, "Array buffer allocation failed");
+			}
+		} else if (info[0]->IsSharedArrayBuffer()) {
+			buffer = v8::Local<v8::SharedArrayBuffer>::Cast(info[0]);
+			size_t byteLength = buffer->ByteLength();
+			uint32_t offset = 0;
+			if (info.Length() > 1) { REQUIRE_ARGUMENT_UINT32(second, offset); }
+			if (offset % sizeof(int64_t) != 0) return ThrowRangeError(info, "Byte offset must be a multiple of 8");
+			if (offset > byteLength) return ThrowRangeError(info, "Byte offset is out of bounds");
+			byteOffset = offset;
+			length = (byteLength - byteOffset) / sizeof(int64_t);
+			if (info.Length() > 2) {
+				uint32_t requested;
+				REQUIRE_ARGUMENT_UINT32(third, requested);
+				if (requested > length) return ThrowRangeError(info, "Length is out of bounds");
+				length = requested;
+			}
+		} else {
+			return ThrowTypeError(info, "Expected a length or SharedArrayBuffer");
+		}
+		v8::Local<v8::BigInt64Array> array = v8::BigInt64Array::New(buffer, byteOffset, length);
+		info.This()->SetInternalField(0, array);
+		info.This()->SetAlignedPointerInInternalField(DATA_FIELD, Int64Data(array));
+		info.GetReturnValue().Set(info.This());
+	}
+
+	NODE_GETTER(Length) {
+		info.GetReturnValue().Set((double)Elements(info.This())->Length());
+	}
+
+	NODE_GETTER(Buffer) {
+		info.GetReturnValue().Set(Elements(info.This())->Buffer());
+	}
+
+	NODE_METHOD(Load) {
+		Element* element;
+		if (!UseElement(info, element)) return;
+		Integer::ReturnNew(info, element->load());
+	}
+
+	NODE_METHOD(Store) {
+		Element* element;
+		int64_t value;
+		if (!UseElement(info, element) || !UseOperand(info, 1, value)) return;
+		element->store(value);
+	}
+
+	NODE_METHOD(Exchange) {
+		Element* element;
+		int64_t value;
+		if (!UseElement(info, element) || !UseOperand(info, 1, value)) return;
+		Integer::ReturnNew(info, element->exchange(value));
+	}
+
+	// Returns the value that was found, which equals the expected value only if
+	// the replacement was stored (just like Atomics.compareExchange).
+	NODE_METHOD(CompareExchange) {
+		Element* element;
+		int64_t expected;
+		int64_t replacement;
+		if (!UseElement(info, element) || !UseOperand(info, 1, expected) || !UseOperand(info, 2, replacement)) return;
+		element->compare_exchange_strong(expected, replacement);
+		Integer::ReturnNew(info, expected);
+	}
+
+	NODE_METHOD(FetchAdd) { FetchAndApply<IntegerArray::AddOp>(info); }
+	NODE_METHOD(FetchSub) { FetchAndApply<IntegerArray::SubtractOp>(info); }
+
+	// Retries until the element is updated without any other thread writing in
+	// between. If the result would overflow, nothing is written at all.
+	template <class Op>
+	static void FetchAndApply(NODE_ARGUMENTS info) {
+		Element* element;
+		int64_t operand;
+		if (!UseElement(info, element) || !UseOperand(info, 1, operand)) return;
+		int64_t current = element->load();
+		do {
+			const Error* error = Op::Check(current, operand);
+			if (error) return ThrowException(info, *error);
+		} while (!element->compare_exchange_weak(current, Op::Apply(current, operand)));
+		Integer::ReturnNew(info, current);
+	}
+
+	static bool UseElement(NODE_ARGUMENTS info, Element*& element) {
+		if (info.Length() == 0 || !info[0]->IsUint32()) {
+			ThrowTypeError(info, "Expected first argument to be a regular 32-bit unsigned integer");
+			return false;
+		}
+		uint32_t index = v8::Local<v8::Uint32>::Cast(info[0])->Value();
+		if (index >= Elements(info.This())->Length()) {
+			ThrowRangeError(info, "Index is out of bounds");
+			return false;
+		}
+		element = static_cast<Element*>(info.This()->GetAlignedPointerFromInternalField(DATA_FIELD)) + index;
+		return true;
+	}
+
+	static bool UseOperand(NODE_ARGUMENTS info, int at, int64_t& value) {
+		if (info.Length() <= at) {
+			ThrowTypeError(info, "Missing argument");
+			return false;
+		}
+		Result cast = Integer::Cast(info, info[at]);
+		if (cast.error) {
+			ThrowException(info, *cast.error);
+			return false;
+		}
+		value = cast.Checked();
+		return true;
+	}
+
+	static inline v8::Local<v8::BigInt64Array> Elements(v8::Local<v8::Object> object) {
+		return object->GetInternalField(0).As<v8::BigInt64Array>();
+	}
+
+	static const int DATA_FIELD = 1;
+};
@@ -0,0 +1,80 @@
+// Sorting kernels for arrays of 64-bit integers. Values are sorted by keys
+// whose sign bit is flipped, so that they sort as unsigned numbers (and
+// flipping every other bit as well sorts them in descending order).
+
+static const uint64_t ASCENDING_KEY = (uint64_t)1 << 63;
+static const uint64_t DESCENDING_KEY = ~ASCENDING_KEY;
+
+// Below this length, the radix sort's histograms cost more than they save.
+static const size_t MIN_RADIX_LENGTH = 256;
+
+// A stable sort by each byte of the keys, starting with the least significant.
+// Passes where every key has the same byte are skipped, so values within a
+// small range take fewer passes. The temp buffer must be as long as the data.
+template <class T, class Key>
+void RadixSort(T* data, T* temp, size_t length, Key key) {
+	std::vector<size_t> counts(8 * 256);
+	for (size_t i = 0; i < length; ++i) {
+		uint64_t k = key(data[i]);
+		for (int byte = 0; byte < 8; ++byte) ++counts[byte * 256 + ((k >> (byte * 8)) & 255)];
+	}
+	int passes[8];
+	int pass_count = 0;
+	uint64_t first = length ? key(data[0]) : 0;
+	for (int byte = 0; byte < 8; ++byte) {
+		if (counts[byte * 256 + ((first >> (byte * 8)) & 255)] != length) passes[pass_count++] = byte;
+	}
+	T* from = data;
+	T* to = temp;
+	for (int pass = 0; pass < pass_count; ++pass) {
+		const int shift = passes[pass] * 8;
+		size_t* offsets = &counts[passes[pass] * 256];
+		size_t offset = 0;
+		for (int digit = 0; digit < 256; ++digit) {
+			size_t count = offsets[digit];
+			offsets[digit] = offset;
+			offset += count;
+		}
+		for (size_t i = 0; i < length; ++i) to[offsets[(key(from[i]) >> shift) & 255]++] = from[i];
+		std::swap(from, to);
+	}
+	if (from != data) memcpy(data, from, length * sizeof(T));
+}
+
+// Sorts the input into the output, which must not overlap it. If there is not
+// enough memory for the radix sort's second buffer, std::sort is used instead.
+void SortValues(const int64_t* in, int64_t* out, size_t length, bool descending) {
+	if (length) memcpy(out, in, length * sizeof(int64_t));
+	int64_t* temp = length >= MIN_RADIX_LENGTH ? static_cast<int64_t*>(malloc(length * sizeof(int64_t))) : NULL;
+	if (temp) {
+		const uint64_t mask = descending ? DESCENDING_KEY : ASCENDING_KEY;
+		RadixSort(out, temp, length, [mask](int64_t value) { return (uint64_t)value ^ mask; });
+		free(temp);
+	} else if (descending) {
+		std::sort(out, out + length, std::greater<int64_t>());
+	} else {
+		std::sort(out, out + length);
+	}
+}
+
+// Writes the indices of the input in sorted order. Equal values keep their
+// original order, in both directions. The keys are sorted together with their
+// indices, so that each pass reads memory sequentially.
+void SortIndices(const int64_t* in, uint32_t* out, size_t length, bool descending) {
+	struct Entry { uint64_t key; uint32_t index; };
+	Entry* entries = length >= MIN_RADIX_LENGTH ? static_cast<Entry*>(malloc(2 * length * sizeof(Entry))) : NULL;
+	if (entries) {
+		const uint64_t mask = descending ? DESCENDING_KEY : ASCENDING_KEY;
+		for (size_t i = 0; i < length; ++i) {
+			entries[i].key = (uint64_t)in[i] ^ mask;
+			entries[i].index = (uint32_t)i;
+		}
+		RadixSort(entries, entries + length, length, [](const Entry& entry) { return entry.key; });
+		for (size_t i = 0; i < length; ++i) out[i] = entries[i].index;
+		free(entries);
+		return;
+	}
+	for (size_t i = 0; i < length; ++i) out[i] = (uint32_t)i;
+	if (descending) std::stable_sort(out, out + length, [in](uint32_t a, uint32_t b) { return in[a] > in[b]; });
+	else std::stable_sort(out, out + length, [in](uint32_t a, uint32_t b) { return in[a] < in[b]; });
+}
@@ -0,0 +1,40 @@
+// Runtime counters, which are only compiled in when INTEGER_STATS is defined
+// (by building with --integer_stats=true). Every environment counts in its own
+// Addon, so no synchronization is needed. The kinds are defined in every build,
+// so that the code which counts them compiles to nothing by default.
+
+struct Stats {
+	// The paths taken by Integer::Cast(), by the type of the argument.
+	enum CastKind { CAST_INT32, CAST_DOUBLE, CAST_INTEGER, CAST_STRING, CAST_BIGINT, CAST_INVALID, CAST_KINDS };
+
+	// Thrown errors, with the most common RangeErrors counted separately.
+	enum ErrorKind { ERROR_OVERFLOW, ERROR_DIVIDE_BY_ZERO, ERROR_CONVERSION, ERROR_RANGE, ERROR_TYPE, ERROR_KINDS };
+
+#ifdef INTEGER_STATS
+	// Every function template is given one of these as its data (instead of
+	// the addon itself), and a trampoline that counts each call before making
+	// it. The getter is only used by accessors.
+	struct CallSite {
+		Addon* addon;
+		std::string name;
+		v8::FunctionCallback method;
+		v8::AccessorGetterCallback getter;
+		uint64_t calls;
+	};
+
+	void Reset() {
+		for (const std::unique_ptr<CallSite>& site : sites) site->calls = 0;
+		std::fill(casts, casts + CAST_KINDS, 0);
+		std::fill(errors, errors + ERROR_KINDS, 0);
+		created = 0;
+		reused = 0;
+	}
+
+	std::vector<std::unique_ptr<CallSite>> sites;
+	const char* current_class = "";
+	uint64_t casts[CAST_KINDS] = {};
+	uint64_t errors[ERROR_KINDS] = {};
+	uint64_t created = 0;
+	uint64_t reused = 0;
+#endif
+};
@@ -78,6 +78,16 @@ describe('Integer.fromString()', function () {
 		equal(fromString('  -.0  '), '0');
 		equal(fromString('  -0.  '), '0');
 	});
+	it('should accept strings of any length and representation', function () {
+		const twoByte = (string) => (string + '\u2003').slice(0, string.length);
+		equal(fromString(twoByte('-9223372036854775808')), '-9223372036854775808');
+		equal(fromString(twoByte(' 450. ')), '450');
+		equal(fromString(' '.repeat(200) + '123' + ' '.repeat(200)), '123');
+		equal(fromString('0'.repeat(300) + '9223372036854775807'), '9223372036854775807');
+		equal(fromString(twoByte('-' + '0'.repeat(300) + '1')), '-1');
+		expect(() => fromString('1'.repeat(300))).to.throw(RangeError);
+		expect(() => fromString('\u2003123')).to.throw(TypeError);
+	});
 	it('should throw when the argument is a string containing invalid whitespace', function () {
 		expect(() => fromString('1 23')).to.throw(TypeError);
 		expect(() => fromString(' - 123')).to.throw(TypeError);
@@ -115,6 +125,30 @@ describe('Integer.fromString()', function () {
 		expect(() => fromString(' -.. ', 36)).to.throw(TypeError);
 		expect(() => fromString('.-', 36)).to.throw(TypeError);
 	});
+	it('should parse long runs of decimal and hexadecimal digits exactly', function () {
+		let seed = 1;
+		const random = (n) => (seed = (seed * 48271) % 2147483647) % n;
+		const min = -(2n ** 63n);
+		const max = 2n ** 63n - 1n;
+		for (const radix of [10, 16]) {
+			const digits = radix === 10 ? '0123456789' : '0123456789abcdefABCDEF';
+			for (let i = 0; i < 3000; ++i) {
+				let string = random(3) ? '' : '-';
+				string += '0'.repeat(random(4) ? 0 : random(12));
+				for (let length = 1 + random(radix === 10 ? 21 : 18); length > 0; --length) string += digits[random(digits.length)];
+				const magnitude = BigInt((radix === 16 ? '0x' : '') + string.replace('-', ''));
+				const expected = string[0] === '-' ? -magnitude : magnitude;
+				if (expected < min || expected > max) {
+					expect(() => fromString(string, radix)).to.throw(RangeError);
+				} else {
+					const result = fromString(string, radix);
+					if (result.toString(radix) !== expected.toString(radix)) expect(result.toString(radix)).to.equal(expected.toString(radix));
+				}
+				const at = random(string.length + 1);
+				expect(() => fromString(string.slice(0, at) + 'gx~'[random(3)] + string.slice(at), radix)).to.throw();
+			}
+		}
+	});
 	it('should only allow bases within 2 - 36', function () {
 		expect(() => fromString('0', 1)).to.throw(RangeError);
 		expect(() => fromString('0', 37)).to.throw(RangeError);
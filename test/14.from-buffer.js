@@ -0,0 +1,87 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(b);
+}
+
+function varint(value) {
+	const bytes = [];
+	let x = BigInt.asUintN(64, value);
+	for (; x >= 0x80n; x >>= 7n) bytes.push(Number(x & 0x7fn) | 0x80);
+	bytes.push(Number(x));
+	return bytes;
+}
+
+const values = ['0', '1', '-1', '127', '128', '-64', '300', '2147483648', '-9223372036854775808', '9223372036854775807'];
+
+describe('Integer.fromBuffer() and Integer#writeTo()', function () {
+	it('should read and write 64-bit values in either byte order', function () {
+		const buffer = Buffer.alloc(20);
+		const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.length);
+		for (const value of values) {
+			expect(Integer(value).writeTo(buffer, 3)).to.equal(11);
+			expect(view.getBigInt64(3, true)).to.equal(BigInt(value));
+			equal(Integer.fromBuffer(buffer, 3), value);
+			equal(Integer.fromBuffer(buffer, 3, { endian: 'little' }), value);
+			expect(Integer(value).writeTo(buffer, 12, { endian: 'big' })).to.equal(20);
+			expect(view.getBigInt64(12, false)).to.equal(BigInt(value));
+			equal(Integer.fromBuffer(buffer, 12, { endian: 'big' }), value);
+		}
+		expect(Integer(-2).writeTo(buffer)).to.equal(8);
+		equal(Integer.fromBuffer(new Uint8Array(buffer.buffer, buffer.byteOffset, 8)), '-2');
+	});
+	it('should throw when the arguments are invalid', function () {
+		const buffer = Buffer.alloc(8);
+		expect(() => Integer.fromBuffer(buffer, 1)).to.throw(RangeError);
+		expect(() => Integer.fromBuffer(buffer, 9)).to.throw(RangeError);
+		expect(() => Integer(1).writeTo(buffer, 1)).to.throw(RangeError);
+		expect(() => Integer.fromBuffer([0, 0, 0, 0, 0, 0, 0, 0])).to.throw(TypeError);
+		expect(() => Integer.fromBuffer(buffer, -1)).to.throw(TypeError);
+		expect(() => Integer.fromBuffer(buffer, 0, 'big')).to.throw(TypeError);
+		expect(() => Integer.fromBuffer(buffer, 0, { endian: 'BE' })).to.throw(TypeError);
+		expect(() => Integer(1).writeTo(buffer, 0, { endian: 1 })).to.throw(TypeError);
+	});
+});
+
+describe('Integer.fromVarint() and Integer#writeVarint()', function () {
+	it('should read and write varints', function () {
+		const buffer = Buffer.alloc(12);
+		for (const value of values) {
+			const bytes = varint(BigInt(value));
+			expect(Integer(value).writeVarint(buffer, 1)).to.equal(1 + bytes.length);
+			expect(Array.from(buffer.slice(1, 1 + bytes.length))).to.deep.equal(bytes);
+			equal(Integer.fromVarint(buffer, 1), value);
+			expect(Integer.varintLength(buffer, 1)).to.equal(bytes.length);
+		}
+		expect(Integer.varintLength(Buffer.from([0xff, 0x80, 0x00]))).to.equal(3);
+		equal(Integer.fromVarint(Buffer.from([0xff, 0x80, 0x00])), '127');
+	});
+	it('should support zigzag encoding', function () {
+		const buffer = Buffer.alloc(10);
+		const zigzag = { zigzag: true };
+		const expected = { '0': [0], '-1': [1], '1': [2], '-64': [127], '127': [0xfe, 0x01] };
+		for (const value in expected) {
+			expect(Integer(value).writeVarint(buffer, 0, zigzag)).to.equal(expected[value].length);
+			expect(Array.from(buffer.slice(0, expected[value].length))).to.deep.equal(expected[value]);
+			equal(Integer.fromVarint(buffer, 0, zigzag), value);
+		}
+		for (const value of values) {
+			Integer(value).writeVarint(buffer, 0, zigzag);
+			equal(Integer.fromVarint(buffer, 0, zigzag), value);
+		}
+		expect(Integer.MIN_VALUE.writeVarint(buffer, 0, zigzag)).to.equal(10);
+		expect(Integer.MIN_VALUE.writeVarint(buffer, 0)).to.equal(10);
+	});
+	it('should throw when the varint is truncated or malformed', function () {
+		expect(() => Integer.fromVarint(Buffer.from([0x80, 0x80]))).to.throw(RangeError, 'Truncated varint');
+		expect(() => Integer.fromVarint(Buffer.from([]))).to.throw(RangeError, 'Truncated varint');
+		expect(() => Integer.fromVarint(Buffer.alloc(11, 0x80))).to.throw(RangeError, 'Malformed varint');
+		expect(() => Integer.fromVarint(Buffer.from([0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02]))).to.throw(RangeError, 'Malformed varint');
+		expect(() => Integer.varintLength(Buffer.from([0x80]))).to.throw(RangeError, 'Truncated varint');
+		expect(() => Integer(300).writeVarint(Buffer.alloc(1))).to.throw(RangeError);
+		expect(() => Integer(1).writeVarint(Buffer.alloc(1), 0, { zigzag: 1 })).to.throw(TypeError);
+	});
+});
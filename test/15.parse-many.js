@@ -0,0 +1,89 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(b);
+}
+
+function unpack(result) {
+	expect(Object.keys(result)).to.deep.equal(['values', 'valid', 'errors']);
+	expect(result.values).to.be.an.instanceof(Integer.Array);
+	expect(result.valid).to.be.an.instanceof(Uint8Array);
+	expect(result.errors).to.be.an.instanceof(Uint8Array);
+	const length = result.values.length;
+	expect(result.valid.length).to.equal(Math.ceil(length / 8));
+	expect(result.errors.length).to.equal(length);
+	const values = result.values.toArray().map(String);
+	const valid = values.map((_, i) => !!(result.valid[i >> 3] & (1 << (i & 7))));
+	return { values, valid, errors: Array.from(result.errors) };
+}
+
+describe('Integer.tryFromString() and Integer.tryFromNumber()', function () {
+	it('should return an Integer when the value can be converted', function () {
+		equal(Integer.tryFromString('123'), '123');
+		equal(Integer.tryFromString(' -9223372036854775808 '), '-9223372036854775808');
+		equal(Integer.tryFromString('ff', 16), '255');
+		equal(Integer.tryFromNumber(-5), '-5');
+		equal(Integer.tryFromNumber(9007199254740991), '9007199254740991');
+	});
+	it('should return null when the value cannot be converted', function () {
+		expect(Integer.tryFromString('')).to.equal(null);
+		expect(Integer.tryFromString('12x')).to.equal(null);
+		expect(Integer.tryFromString('9223372036854775808')).to.equal(null);
+		expect(Integer.tryFromString('g', 16)).to.equal(null);
+		expect(Integer.tryFromNumber(1.5)).to.equal(null);
+		expect(Integer.tryFromNumber(NaN)).to.equal(null);
+		expect(Integer.tryFromNumber(9007199254740992)).to.equal(null);
+	});
+	it('should still throw when the arguments are invalid', function () {
+		expect(() => Integer.tryFromString()).to.throw(TypeError);
+		expect(() => Integer.tryFromString(123)).to.throw(TypeError);
+		expect(() => Integer.tryFromString('1', 1)).to.throw(RangeError);
+		expect(() => Integer.tryFromString('1', '10')).to.throw(TypeError);
+		expect(() => Integer.tryFromNumber('1')).to.throw(TypeError);
+	});
+});
+
+describe('Integer.parseMany()', function () {
+	it('should parse an array, reporting each invalid value', function () {
+		const result = unpack(Integer.parseMany(['1', ' -2 ', 'abc', '', 1.5, '99999999999999999999', 9007199254740992, null, Integer(7), 8, '1.0']));
+		expect(result.values).to.deep.equal(['1', '-2', '0', '0', '0', '0', '0', '0', '7', '8', '1']);
+		expect(result.valid).to.deep.equal([true, true, false, false, false, false, false, false, true, true, true]);
+		expect(result.errors).to.deep.equal([0, 0, 5, 4, 2, 6, 3, 1, 0, 0, 0]);
+		expect(unpack(Integer.parseMany(['ff', 'fg', '-7fffffffffffffff'], 16)).values).to.deep.equal(['255', '0', '-9223372036854775807']);
+		expect(unpack(Integer.parseMany([])).values).to.deep.equal([]);
+	});
+	it('should parse separated values in a buffer', function () {
+		let result = unpack(Integer.parseMany(Buffer.from('12,-3,x, 4 ,,9223372036854775807,9223372036854775808,')));
+		expect(result.values).to.deep.equal(['12', '-3', '0', '4', '0', '9223372036854775807', '0']);
+		expect(result.errors).to.deep.equal([0, 0, 5, 0, 4, 0, 6]);
+		result = unpack(Integer.parseMany(Buffer.from('ff\r\n10\r\nzz\r\n'), 16, '\n'));
+		expect(result.values).to.deep.equal(['255', '16', '0']);
+		expect(result.valid).to.deep.equal([true, true, false]);
+		expect(unpack(Integer.parseMany(new Uint8Array(0))).values).to.deep.equal([]);
+		expect(unpack(Integer.parseMany(Buffer.from(','))).errors).to.deep.equal([4]);
+		expect(unpack(Integer.parseMany(Buffer.from('1,2'), undefined, ';')).errors).to.deep.equal([5]);
+	});
+	it('should agree with Integer.fromString() on many values', function () {
+		const strings = [];
+		for (let i = 0; i < 1000; ++i) {
+			strings.push(i % 7 === 0 ? `${i}?` : String(i * 987654321987 - 400000000000000));
+		}
+		const expected = strings.map(s => Integer.tryFromString(s));
+		for (const input of [strings, Buffer.from(strings.join('\n'))]) {
+			const result = unpack(Integer.parseMany(input, 10, '\n'));
+			expect(result.valid).to.deep.equal(expected.map(x => x !== null));
+			expect(result.values).to.deep.equal(expected.map(x => String(x || 0)));
+		}
+	});
+	it('should throw when the arguments are invalid', function () {
+		expect(() => Integer.parseMany()).to.throw(TypeError);
+		expect(() => Integer.parseMany('1,2')).to.throw(TypeError);
+		expect(() => Integer.parseMany(['1'], 37)).to.throw(RangeError);
+		expect(() => Integer.parseMany(['1'], 10, ', ')).to.throw(TypeError);
+		expect(() => Integer.parseMany(['1'], 10, 'é')).to.throw(TypeError);
+		expect(() => Integer.parseMany(Buffer.from('1'), 10, 44)).to.throw(TypeError);
+	});
+});
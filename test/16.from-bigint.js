@@ -0,0 +1,81 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+const fromBigInt = Integer.fromBigInt;
+
+const MAX = 2n ** 63n - 1n;
+const MIN = -(2n ** 63n);
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(String(b));
+}
+
+describe('Integer.fromBigInt()', function () {
+	it('should work with a BigInt argument', function () {
+		equal(fromBigInt(0n), 0n);
+		equal(fromBigInt(123n), 123n);
+		equal(fromBigInt(-123n), -123n);
+		equal(fromBigInt(MAX), MAX);
+		equal(fromBigInt(MIN), MIN);
+		equal(fromBigInt(2n ** 53n + 1n), 2n ** 53n + 1n);
+		expect(fromBigInt(0n)).to.equal(Integer.ZERO);
+	});
+	it('should throw when the argument is an unaccepted type', function () {
+		expect(() => fromBigInt()).to.throw(TypeError, 'Expected first argument to be a BigInt');
+		expect(() => fromBigInt(123)).to.throw(TypeError);
+		expect(() => fromBigInt('123')).to.throw(TypeError);
+		expect(() => fromBigInt(Object(123n))).to.throw(TypeError);
+		expect(() => fromBigInt(Integer(123))).to.throw(TypeError);
+	});
+	it('should throw when the argument does not fit in 64 bits', function () {
+		expect(() => fromBigInt(MAX + 1n)).to.throw(RangeError, 'The given BigInt is too large');
+		expect(() => fromBigInt(MIN - 1n)).to.throw(RangeError);
+		expect(() => fromBigInt(2n ** 64n)).to.throw(RangeError);
+		expect(() => fromBigInt(-(2n ** 200n))).to.throw(RangeError);
+	});
+});
+
+describe('Integer.tryFromBigInt()', function () {
+	it('should return null instead of throwing', function () {
+		equal(Integer.tryFromBigInt(MIN), MIN);
+		expect(Integer.tryFromBigInt(MAX + 1n)).to.equal(null);
+		expect(() => Integer.tryFromBigInt(1)).to.throw(TypeError);
+	});
+});
+
+describe('Integer#toBigInt()', function () {
+	it('should losslessly convert every value', function () {
+		for (const value of [0n, 1n, -1n, MAX, MIN, 2n ** 53n + 1n, -(2n ** 32n)]) {
+			const bigint = Integer.fromBigInt(value).toBigInt();
+			expect(typeof bigint).to.equal('bigint');
+			expect(bigint === value).to.be.true;
+		}
+		expect(Integer('-987654321098765432').toBigInt() === -987654321098765432n).to.be.true;
+	});
+});
+
+describe('BigInt arguments', function () {
+	it('should be accepted wherever an Integer is', function () {
+		equal(Integer(MAX), MAX);
+		equal(Integer(5).add(10n), 15n);
+		equal(Integer(MIN).subtract(-1n), MIN + 1n);
+		expect(Integer(7).equals(7n)).to.be.true;
+		expect(Integer(7).compare(8n)).to.equal(-1);
+		expect(Integer(7).greaterThan(MIN)).to.be.true;
+		expect(() => Integer(MAX).add(1n)).to.throw(RangeError, 'Integer overflow');
+		expect(() => Integer(1).add(MAX + 1n)).to.throw(RangeError, 'The given BigInt is too large');
+		expect(() => Integer(MAX + 1n)).to.throw(RangeError);
+	});
+	it('should be accepted by the bulk operations', function () {
+		const array = Integer.Array.from([1n, MIN, '3', Integer(4), 5]);
+		expect(Array.from(array.asBigInt64Array())).to.deep.equal([1n, MIN, 3n, 4n, 5n]);
+		expect(array.add(1n).get(0).toBigInt() === 2n).to.be.true;
+		expect(() => Integer.Array.from([1n, 2n ** 64n])).to.throw(RangeError);
+		const set = new Integer.Set([1n, 1, '1', MAX]);
+		expect(set.size).to.equal(2);
+		expect(set.has(MAX)).to.be.true;
+		const parsed = Integer.parseMany([1n, MAX + 1n, 'x']);
+		expect(Array.from(parsed.errors)).to.deep.equal([0, 7, 5]);
+	});
+});
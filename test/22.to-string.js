@@ -37,6 +37,22 @@ describe('Integer#toString()', function () {
 		}
 		expect(count).to.equal(5);
 	});
+	it('should match BigInt for every radix and number of digits', function () {
+		const values = [0n, 1n, -1n, 9223372036854775807n, -9223372036854775808n];
+		for (let bits = 1n; bits < 63n; ++bits) {
+			values.push(1n << bits, (1n << bits) - 1n, -(1n << bits), -(1n << bits) + 1n);
+			values.push(BigInt.asIntN(64, BigInt(Math.floor(Math.random() * 2 ** 32)) << 32n | BigInt(Math.floor(Math.random() * 2 ** 32))) >> (64n - bits));
+		}
+		for (let power = 1n, i = 0; i < 19; ++i, power *= 10n) {
+			values.push(power, power - 1n, -power, 1n - power);
+		}
+		for (const value of values) {
+			const int = Integer(String(value));
+			for (let radix = 2; radix <= 36; ++radix) {
+				expect(int.toString(radix)).to.equal(value.toString(radix));
+			}
+		}
+	});
 	it('should throw when an invalid radix is provided', function () {
 		const int = Integer('0');
 		expect(() => int.toString(0)).to.throw(RangeError);
@@ -58,3 +74,31 @@ describe('Integer#toString()', function () {
 		expect(() => int.toString(undefined)).to.throw(TypeError);
 	});
 });
+
+describe('Integer.writeText()', function () {
+	it('should write separated base-10 values into a buffer', function () {
+		const buffer = Buffer.alloc(64);
+		const values = [0, -1, '9223372036854775807', Integer('-9223372036854775808'), 12345678];
+		const text = values.map(String).join(',');
+		expect(Integer.writeText(values, buffer)).to.equal(text.length);
+		expect(buffer.toString('latin1', 0, text.length)).to.equal(text);
+		const bigints = new BigInt64Array([100000000n, -99999999n, 7n]);
+		expect(Integer.writeText(bigints, buffer, 4, ' \u00e9 ')).to.equal(4 + 27);
+		expect(buffer.toString('utf8', 4, 31)).to.equal('100000000 \u00e9 -99999999 \u00e9 7');
+		expect(Integer.writeText([], buffer, 64)).to.equal(64);
+		expect(Integer.writeText([5], new Uint8Array(buffer.buffer, buffer.byteOffset + 10, 1))).to.equal(1);
+		expect(buffer[10]).to.equal(0x35);
+	});
+	it('should throw when the values or the buffer are invalid', function () {
+		const buffer = Buffer.alloc(8);
+		expect(() => Integer.writeText([123456789], buffer)).to.throw(RangeError);
+		expect(() => Integer.writeText([1, 2, 3], buffer, 4)).to.throw(RangeError);
+		expect(() => Integer.writeText([1], buffer, 9)).to.throw(RangeError);
+		expect(() => Integer.writeText([1], buffer, 0, 'x'.repeat(17))).to.throw(RangeError);
+		expect(() => Integer.writeText([1.5], buffer)).to.throw(TypeError);
+		expect(() => Integer.writeText('1', buffer)).to.throw(TypeError);
+		expect(() => Integer.writeText([1], [])).to.throw(TypeError);
+		expect(() => Integer.writeText([1], buffer, -1)).to.throw(TypeError);
+		expect(() => Integer.writeText([1], buffer, 0, 1)).to.throw(TypeError);
+	});
+});
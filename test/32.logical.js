@@ -38,6 +38,21 @@ describe('Logical operations', function () {
 		expect(Integer('23454').compare(23454)).to.equal(0);
 		expect(Integer('-9223372036854775807').compare(Integer('-9223372036854775808'))).to.equal(1);
 	});
+	it('should behave the same when called repeatedly from hot code', function () {
+		const int = Integer(1000);
+		const args = [999, 1000.5, 1001, -0, 2 ** 53, Integer(1000), Integer('-9223372036854775808'), '1000', null];
+		const expected = [1, null, -1, 1, null, 0, 1, 0, null];
+		for (let i = 0; i < 20000; ++i) {
+			const index = i % args.length;
+			let result = null;
+			try { result = int.compare(args[index]); } catch (_) {}
+			if (result !== expected[index]) expect(result).to.equal(expected[index]);
+		}
+		const ints = [];
+		for (let i = 0; i < 2000; ++i) ints.push(Integer((i * 7919) % 2003 - 1000));
+		ints.sort((a, b) => a.compare(b));
+		for (let i = 1; i < ints.length; ++i) expect(ints[i - 1].lessThanOrEquals(ints[i])).to.be.true;
+	});
 	describe('should throw when an invalid argument is provided', function () {
 		let count = 0;
 		['equals', 'notEquals', 'greaterThan', 'lessThan', 'greaterThanOrEquals', 'lessThanOrEquals', 'compare'].forEach((method) => {
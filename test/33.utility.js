@@ -106,6 +106,7 @@ describe('Utility', function () {
 		expect(isInstance(Object.create(Integer.prototype))).to.be.false;
 		expect(isInstance(Object.create(Integer()))).to.be.false;
 		expect(isInstance(copycat)).to.be.false;
+		expect(isInstance(new Integer.SharedArray(1))).to.be.false;
 		expect(isInstance(Integer())).to.be.true;
 		expect(isInstance(Integer('9223372036854775807'))).to.be.true;
 		expect(isInstance(Integer('-9223372036854775808'))).to.be.true;
@@ -0,0 +1,168 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(b);
+}
+
+const MAX = '9223372036854775807';
+const MIN = '-9223372036854775808';
+
+// Reference implementations, whose results are checked against 64-bit bounds.
+const big = x => BigInt(x.toString());
+const truncDiv = (n, d) => n / d;
+const floorDiv = (n, d) => (n % d !== BigInt(0) && (n < 0) !== (d < 0) ? n / d - BigInt(1) : n / d);
+
+function randoms(count, seed) {
+	const values = [];
+	let x = seed;
+	const next = () => (x = Math.imul(x, 1103515245) + 12345 | 0);
+	for (let i = 0; i < count; ++i) {
+		const value = Integer.fromBits(next(), next());
+		values.push(value.shiftRight(next() & 63));
+	}
+	return values;
+}
+
+describe('Arithmetic operations with 128-bit intermediates', function () {
+	specify('Integer#mulDiv()', function () {
+		equal(Integer(MAX).mulDiv(MAX, MAX), MAX);
+		equal(Integer(MIN).mulDiv(3, 4), '-6917529027641081856');
+		equal(Integer('3000000000000').mulDiv('5000000000000', '7000000000000'), '2142857142857');
+		equal(Integer(7).mulDiv(1, 2), '3');
+		equal(Integer(-7).mulDiv(1, 2), '-3');
+		equal(Integer(7).mulDiv(1, 2, 'floor'), '3');
+		equal(Integer(-7).mulDiv(1, 2, 'floor'), '-4');
+		equal(Integer(7).mulDiv(1, 2, 'ceil'), '4');
+		equal(Integer(-7).mulDiv(1, 2, 'ceil'), '-3');
+		equal(Integer(-7).mulDiv(1, 2, 'expand'), '-4');
+		equal(Integer(-7).mulDiv(1, 2, 'halfExpand'), '-4');
+		equal(Integer(7).mulDiv(1, 2, 'halfEven'), '4');
+		equal(Integer(5).mulDiv(1, 2, 'halfEven'), '2');
+		equal(Integer(5).mulDiv(1, 3, 'halfExpand'), '2');
+		equal(Integer(4).mulDiv(1, 3, 'halfExpand'), '1');
+		equal(Integer(MIN).mulDiv(1, 1, 'expand'), MIN);
+		const xs = randoms(1000, 1);
+		const ys = randoms(1000, 2);
+		const ds = randoms(1000, 3);
+		for (let i = 0; i < xs.length; ++i) {
+			if (ds[i].isZero()) continue;
+			const n = big(xs[i]) * big(ys[i]);
+			const d = big(ds[i]);
+			for (const [mode, expected] of [['trunc', truncDiv(n, d)], ['floor', floorDiv(n, d)]]) {
+				if (expected > big(MAX) || expected < big(MIN)) {
+					expect(() => xs[i].mulDiv(ys[i], ds[i], mode)).to.throw(RangeError, 'Integer overflow');
+				} else {
+					equal(xs[i].mulDiv(ys[i], ds[i], mode), expected.toString());
+				}
+			}
+		}
+	});
+	specify('Integer#mulMod()', function () {
+		equal(Integer(MAX).mulMod(MAX, 1000000007), String(big(MAX) * big(MAX) % BigInt(1000000007)));
+		equal(Integer(MIN).mulMod(MIN, MAX), '1');
+		equal(Integer(-7).mulMod(3, 5), '-1');
+		equal(Integer(-7).mulMod(-3, -5), '1');
+		equal(Integer(123).mulMod(456, MIN), '56088');
+		const xs = randoms(200, 5);
+		const ys = randoms(200, 6);
+		const ms = randoms(200, 7);
+		for (let i = 0; i < xs.length; ++i) {
+			if (ms[i].isZero()) continue;
+			equal(xs[i].mulMod(ys[i], ms[i]), String(big(xs[i]) * big(ys[i]) % big(ms[i])));
+		}
+	});
+	specify('Integer#pow()', function () {
+		equal(Integer(2).pow(62), '4611686018427387904');
+		equal(Integer(-2).pow(63), MIN);
+		equal(Integer(3).pow(39), '4052555153018976267');
+		equal(Integer(-3).pow(3), '-27');
+		equal(Integer(0).pow(0), '1');
+		equal(Integer(1).pow(MAX), '1');
+		equal(Integer(-1).pow(MAX), '-1');
+		equal(Integer(0).pow(MAX), '0');
+	});
+	specify('Integer#powMod()', function () {
+		equal(Integer(2).powMod(MAX, 1000000007), String(modPow(BigInt(2), big(MAX), BigInt(1000000007))));
+		equal(Integer(MAX).powMod(MAX, MIN), String(modPow(big(MAX), big(MAX), big(MIN))));
+		equal(Integer(-3).powMod(3, 5), '-2');
+		equal(Integer(-3).powMod(2, 5), '4');
+		equal(Integer(5).powMod(0, 1), '0');
+		equal(Integer(5).powMod(0, 7), '1');
+	});
+	specify('Integer#gcd() and Integer#lcm()', function () {
+		equal(Integer(12).gcd(-18), '6');
+		equal(Integer(0).gcd(-5), '5');
+		equal(Integer(0).gcd(0), '0');
+		equal(Integer(MIN).gcd(6), '2');
+		equal(Integer(-4).lcm(6), '12');
+		equal(Integer(0).lcm(6), '0');
+		equal(Integer('3037000499').lcm('3037000493'), '9223372012704246007');
+		equal(Integer(MAX).lcm(MAX), MAX);
+	});
+	specify('Integer#sqrt()', function () {
+		equal(Integer(0).sqrt(), '0');
+		equal(Integer(15).sqrt(), '3');
+		equal(Integer(16).sqrt(), '4');
+		equal(Integer(MAX).sqrt(), '3037000499');
+		equal(Integer('9223372030926249001').sqrt(), '3037000499');
+		equal(Integer('9223372030926249000').sqrt(), '3037000498');
+		equal(Integer('9007199136250225').sqrt(), '94906265');
+		equal(Integer('9007199136250224').sqrt(), '94906264');
+	});
+	describe('should throw when overflow would occur', function () {
+		specify('Integer#mulDiv()', function () {
+			expect(() => Integer(MAX).mulDiv(2, 1)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MIN).mulDiv(-1, 1)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MAX).mulDiv(MAX, '9223372036854775806')).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MAX).mulDiv(3, 2, 'trunc')).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MIN).mulDiv(MIN, MAX)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MAX).mulDiv(2, '-2')).to.not.throw();
+			expect(() => Integer(MAX).mulDiv(MAX, MAX, 'ceil')).to.not.throw();
+		});
+		specify('Integer#pow()', function () {
+			expect(() => Integer(2).pow(63)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(-2).pow(64)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(3).pow(40)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer('4294967296').pow(3)).to.throw(RangeError, 'Integer overflow');
+		});
+		specify('Integer#gcd() and Integer#lcm()', function () {
+			expect(() => Integer(MIN).gcd(0)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MIN).gcd(MIN)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MIN).lcm(1)).to.throw(RangeError, 'Integer overflow');
+			expect(() => Integer(MAX).lcm('9223372036854775806')).to.throw(RangeError, 'Integer overflow');
+		});
+	});
+	describe('should throw when an invalid argument is provided', function () {
+		specify('Integer#mulDiv()', function () {
+			expect(() => Integer(1).mulDiv(1)).to.throw(TypeError, 'Missing argument');
+			expect(() => Integer(1).mulDiv(1, 0)).to.throw(RangeError, 'Divide by zero');
+			expect(() => Integer(1).mulDiv(1, 1.5)).to.throw(TypeError);
+			expect(() => Integer(1).mulDiv(1, 2, 'round')).to.throw(TypeError);
+		});
+		specify('Integer#mulMod() and Integer#powMod()', function () {
+			expect(() => Integer(1).mulMod(1, 0)).to.throw(RangeError, 'Divide by zero');
+			expect(() => Integer(1).powMod(1, 0)).to.throw(RangeError, 'Divide by zero');
+			expect(() => Integer(1).powMod(-1, 5)).to.throw(RangeError, 'Exponent must be non-negative');
+			expect(() => Integer(1).powMod(1)).to.throw(TypeError, 'Missing argument');
+		});
+		specify('Integer#pow() and Integer#sqrt()', function () {
+			expect(() => Integer(2).pow(-1)).to.throw(RangeError, 'Exponent must be non-negative');
+			expect(() => Integer(2).pow()).to.throw(TypeError, 'Missing argument');
+			expect(() => Integer(-1).sqrt()).to.throw(RangeError);
+		});
+	});
+});
+
+function modPow(base, exponent, modulus) {
+	const m = modulus < 0 ? -modulus : modulus;
+	let result = BigInt(1) % m;
+	let b = (base < 0 ? -base : base) % m;
+	for (let e = exponent; e > 0; e >>= BigInt(1)) {
+		if (e & BigInt(1)) result = result * b % m;
+		b = b * b % m;
+	}
+	return base < 0 && exponent & BigInt(1) ? -result : result;
+}
@@ -0,0 +1,42 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+describe('Identity', function () {
+	it('should return the same object when casting an Integer', function () {
+		const int = Integer('9007199254740993');
+		expect(Integer(int)).to.equal(int);
+		expect(Integer.fromNumber(NaN, int)).to.equal(int);
+		expect(Integer.fromString('abc', 10, int)).to.equal(int);
+	});
+	it('should return the receiver when an operation does not change it', function () {
+		const int = Integer('-9007199254740993');
+		expect(int.add(0)).to.equal(int);
+		expect(int.subtract('0')).to.equal(int);
+		expect(int.multiply(Integer.ONE)).to.equal(int);
+		expect(int.divide(1)).to.equal(int);
+		expect(int.and(-1)).to.equal(int);
+		expect(int.or(0)).to.equal(int);
+		expect(int.xor(0)).to.equal(int);
+		expect(int.shiftLeft(0)).to.equal(int);
+		expect(int.shiftRight(64)).to.equal(int);
+		const abs = int.abs();
+		expect(abs).to.not.equal(int);
+		expect(abs.abs()).to.equal(abs);
+		expect(Integer.MAX_VALUE.modulo(Integer.MIN_VALUE)).to.equal(Integer.MAX_VALUE);
+	});
+	it('should share instances of commonly used values', function () {
+		expect(Integer(0)).to.equal(Integer.ZERO);
+		expect(Integer('1')).to.equal(Integer.ONE);
+		expect(Integer.fromBits(-1, -1)).to.equal(Integer.NEG_ONE);
+		expect(Integer(-128)).to.equal(Integer(-128));
+		expect(Integer(1023)).to.equal(Integer(1023));
+		expect(Integer(5).add(5)).to.equal(Integer(10));
+		expect(Integer.fromString('7fffffffffffffff', 16)).to.equal(Integer.MAX_VALUE);
+		expect(Integer.MAX_VALUE.not()).to.equal(Integer.MIN_VALUE);
+		expect(Integer(-129)).to.not.equal(Integer(-129));
+		expect(Integer(1024)).to.not.equal(Integer(1024));
+		expect(Integer(1024).toNumber()).to.equal(1024);
+		expect(Integer(-129).toNumber()).to.equal(-129);
+	});
+});
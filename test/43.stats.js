@@ -0,0 +1,60 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+describe('Integer.stats()', function () {
+	if (typeof Integer.stats !== 'function') {
+		it('should only be defined when built with integer_stats', function () {
+			expect(Integer.stats).to.equal(undefined);
+			expect(Integer.resetStats).to.equal(undefined);
+		});
+		return;
+	}
+
+	it('should count calls, casts, and allocations', function () {
+		Integer.resetStats();
+		const a = Integer(123456789);
+		a.add(7).add('7').add(7n).add(Integer(1234567)).add(0);
+		a.low;
+		Integer.fromString('12345678901');
+		Integer.Array.from([1, 2.5e9]).sum();
+		const stats = Integer.stats();
+		expect(stats.calls['Integer']).to.equal(2);
+		expect(stats.calls['Integer#add']).to.equal(5);
+		expect(stats.calls['Integer#low']).to.equal(1);
+		expect(stats.calls['Integer.fromString']).to.equal(1);
+		expect(stats.calls['IntegerArray.from']).to.equal(1);
+		expect(stats.calls['IntegerArray#sum']).to.equal(1);
+		expect(stats.calls['Integer.stats']).to.equal(1);
+		expect(stats.calls['Integer#subtract']).to.equal(undefined);
+		expect(stats.casts).to.deep.equal({ int32: 5, double: 1, integer: 1, string: 1, bigint: 1, invalid: 0 });
+		expect(stats.integers).to.deep.equal({ created: 8, reused: 1 });
+		expect(JSON.parse(JSON.stringify(stats))).to.deep.equal(stats);
+	});
+	it('should count thrown errors by kind', function () {
+		Integer.resetStats();
+		const attempts = [
+			() => Integer.MAX_VALUE.add(1),
+			() => Integer.Array.from([Integer.MAX_VALUE]).multiply(2),
+			() => Integer(1).divide(0),
+			() => Integer.compile([['divide', 0]]).applyAll(Integer.Array.from([1, 2])),
+			() => Integer(1.5),
+			() => Integer.Decimal('1.x'),
+			() => Integer.Array.from([1, 'x']),
+			() => Integer(1).toString(99),
+			() => Integer.fromBits('1'),
+		];
+		for (const attempt of attempts) {
+			try { attempt(); } catch (_) {}
+		}
+		expect(Integer.stats().errors).to.deep.equal({ overflow: 2, divideByZero: 2, conversion: 3, otherRangeError: 1, otherTypeError: 1 });
+	});
+	it('should be reset to zero', function () {
+		Integer(1).add(1);
+		Integer.resetStats();
+		const stats = Integer.stats();
+		expect(stats.calls).to.deep.equal({ 'Integer.stats': 1 });
+		expect(stats.integers).to.deep.equal({ created: 0, reused: 0 });
+		expect(stats.errors.overflow).to.equal(0);
+	});
+});
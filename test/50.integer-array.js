@@ -0,0 +1,210 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+const IntegerArray = Integer.Array;
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(IntegerArray);
+	expect(a.toArray().map(String)).to.deep.equal(b);
+}
+
+describe('Integer.Array', function () {
+	it('should be constructable from a length', function () {
+		const array = new IntegerArray(3);
+		expect(array.length).to.equal(3);
+		equal(array, ['0', '0', '0']);
+		equal(new IntegerArray(), []);
+		expect(() => IntegerArray(3)).to.throw(TypeError);
+		expect(() => new IntegerArray('3')).to.throw(TypeError);
+		expect(() => new IntegerArray({})).to.throw(TypeError);
+	});
+	it('should throw a RangeError when it cannot be allocated', function () {
+		// Like the built-in constructor (which succeeds where memory is overcommitted).
+		try { new BigInt64Array(4294967295); } catch (_) {
+			expect(() => new IntegerArray(4294967295)).to.throw(RangeError);
+		}
+	});
+	it('should share memory with a BigInt64Array', function () {
+		const bigints = new BigInt64Array([1n, -2n, 9223372036854775807n]);
+		const array = new IntegerArray(bigints);
+		equal(array, ['1', '-2', '9223372036854775807']);
+		bigints[0] = 5n;
+		expect(array.get(0).toNumber()).to.equal(5);
+		array.set(1, Integer(7));
+		expect(bigints[1]).to.equal(7n);
+		expect(array.asBigInt64Array()).to.equal(bigints);
+	});
+	it('should share memory with an ArrayBuffer', function () {
+		const buffer = new ArrayBuffer(32);
+		const array = new IntegerArray(buffer, 8, 2);
+		array.set(0, '-9223372036854775808');
+		expect(new BigInt64Array(buffer)[1]).to.equal(-9223372036854775808n);
+		expect(new IntegerArray(buffer).length).to.equal(4);
+		expect(new IntegerArray(buffer, 24).length).to.equal(1);
+		expect(() => new IntegerArray(buffer, 4)).to.throw(RangeError);
+		expect(() => new IntegerArray(buffer, 40)).to.throw(RangeError);
+		expect(() => new IntegerArray(buffer, 8, 4)).to.throw(RangeError);
+	});
+	specify('Integer.Array.from()', function () {
+		equal(IntegerArray.from([1, '2', Integer(-3)]), ['1', '2', '-3']);
+		expect(() => IntegerArray.from([1, 2.5])).to.throw(TypeError);
+		expect(() => IntegerArray.from([Number.MAX_SAFE_INTEGER + 1])).to.throw(RangeError);
+		expect(() => IntegerArray.from('123')).to.throw(TypeError);
+	});
+	specify('Integer.Array#get() and Integer.Array#set()', function () {
+		const array = IntegerArray.from([10, 20]);
+		expect(array.get(1)).to.be.an.instanceof(Integer);
+		expect(array.get(1).toNumber()).to.equal(20);
+		expect(() => array.get(2)).to.throw(RangeError);
+		expect(() => array.get(-1)).to.throw(TypeError);
+		expect(() => array.set(2, 0)).to.throw(RangeError);
+		expect(() => array.set(0)).to.throw(TypeError);
+		expect(() => array.set(0, 'abc')).to.throw(TypeError);
+	});
+	it('should perform element-wise and scalar arithmetic', function () {
+		const a = IntegerArray.from([10, -20, 30, 400]);
+		const b = IntegerArray.from([3, 3, -7, 400]);
+		equal(a.add(b), ['13', '-17', '23', '800']);
+		equal(a.subtract(b.asBigInt64Array()), ['7', '-23', '37', '0']);
+		equal(a.multiply(b), ['30', '-60', '-210', '160000']);
+		equal(a.divide(b), ['3', '-6', '-4', '1']);
+		equal(a.modulo(b), ['1', '-2', '2', '0']);
+		equal(a.add(1), ['11', '-19', '31', '401']);
+		equal(a.multiply('-2'), ['-20', '40', '-60', '-800']);
+		equal(a.divide(Integer(3)), ['3', '-6', '10', '133']);
+		equal(a.modulo(-1), ['0', '0', '0', '0']);
+		expect(() => a.add(IntegerArray.from([1]))).to.throw(RangeError);
+		expect(() => a.add()).to.throw(TypeError);
+		expect(() => a.add(1.5)).to.throw(TypeError);
+		expect(() => a.add(new Integer.SharedArray(4))).to.throw(TypeError);
+	});
+	it('should report the first index that overflows', function () {
+		const max = '9223372036854775807';
+		const min = '-9223372036854775808';
+		const values = [];
+		for (let i = 0; i < 1000; ++i) values.push(i);
+		values[700] = max;
+		values[900] = max;
+		const array = IntegerArray.from(values);
+		expect(() => array.add(1)).to.throw(RangeError, 'Integer overflow at index 700');
+		expect(() => array.multiply(2)).to.throw(RangeError, 'Integer overflow at index 700');
+		expect(() => array.subtract(-1)).to.throw(RangeError, 'Integer overflow at index 700');
+		expect(() => IntegerArray.from([0, min]).subtract(1)).to.throw(RangeError, 'Integer overflow at index 1');
+		equal(IntegerArray.from(['-4611686018427387904', '3037000499']).multiply(IntegerArray.from([2, '3037000499'])), [min, '9223372030926249001']);
+		expect(() => IntegerArray.from([1, '-4611686018427387904']).multiply(-2)).to.throw(RangeError, 'Integer overflow at index 1');
+		expect(() => IntegerArray.from([1, min]).divide(-1)).to.throw(RangeError, 'Integer overflow at index 1');
+		expect(() => IntegerArray.from([1, 2]).divide(0)).to.throw(RangeError, 'Divide by zero at index 0');
+		expect(() => IntegerArray.from([1, 2]).modulo(IntegerArray.from([1, 0]))).to.throw(RangeError, 'Divide by zero at index 1');
+		equal(IntegerArray.from([min]).modulo(-1), ['0']);
+	});
+	it('should perform bitwise operations and shifts', function () {
+		const a = IntegerArray.from([12, -1, 0]);
+		equal(a.and(10), ['8', '10', '0']);
+		equal(a.or(IntegerArray.from([1, 0, 2])), ['13', '-1', '2']);
+		equal(a.xor(-1), ['-13', '0', '-1']);
+		equal(a.not(), ['-13', '0', '-1']);
+		equal(a.shiftLeft(2), ['48', '-4', '0']);
+		equal(a.shiftRight(2), ['3', '-1', '0']);
+		equal(a.shiftLeft(66), ['48', '-4', '0']);
+		expect(() => a.shiftLeft(-1)).to.throw(TypeError);
+	});
+	it('should perform comparisons', function () {
+		const a = IntegerArray.from([1, 2, 3]);
+		const b = IntegerArray.from([3, 2, 1]);
+		const bytes = (array) => {
+			expect(array).to.be.an.instanceof(Uint8Array);
+			return Array.from(array);
+		};
+		expect(bytes(a.equals(b))).to.deep.equal([0, 1, 0]);
+		expect(bytes(a.notEquals(b))).to.deep.equal([1, 0, 1]);
+		expect(bytes(a.greaterThan(2))).to.deep.equal([0, 0, 1]);
+		expect(bytes(a.greaterThanOrEquals('2'))).to.deep.equal([0, 1, 1]);
+		expect(bytes(a.lessThan(b))).to.deep.equal([1, 0, 0]);
+		expect(bytes(a.lessThanOrEquals(b))).to.deep.equal([1, 1, 0]);
+	});
+	it('should perform reductions', function () {
+		const a = IntegerArray.from([5, -3, 0, 12, 0]);
+		expect(a.sum().toNumber()).to.equal(14);
+		expect(a.min().toNumber()).to.equal(-3);
+		expect(a.max().toNumber()).to.equal(12);
+		expect(a.countNonZero()).to.equal(3);
+		const empty = new IntegerArray(0);
+		expect(empty.sum().toNumber()).to.equal(0);
+		expect(empty.min()).to.equal(undefined);
+		expect(empty.max()).to.equal(undefined);
+		expect(empty.countNonZero()).to.equal(0);
+		const overflow = new IntegerArray(600);
+		overflow.set(10, Integer.MAX_VALUE);
+		overflow.set(400, 1);
+		expect(() => overflow.sum()).to.throw(RangeError, 'Integer overflow at index 400');
+		overflow.set(500, -1);
+		expect(() => overflow.sum()).to.throw(RangeError, 'Integer overflow at index 400');
+		overflow.set(400, -1);
+		expect(overflow.sum().toString()).to.equal('9223372036854775805');
+	});
+	specify('Integer.Array.fromBuffer() and Integer.Array#writeTo()', function () {
+		const array = IntegerArray.from([1, -2, '9223372036854775807']);
+		const buffer = Buffer.alloc(30);
+		expect(array.writeTo(buffer, 2, { endian: 'big' })).to.equal(26);
+		expect(buffer.readUInt32BE(6)).to.equal(1);
+		equal(IntegerArray.fromBuffer(buffer, 2, undefined, { endian: 'big' }), ['1', '-2', '9223372036854775807']);
+		equal(IntegerArray.fromBuffer(buffer, 10, 1, { endian: 'big' }), ['-2']);
+		expect(array.writeTo(buffer)).to.equal(24);
+		equal(IntegerArray.fromBuffer(buffer), ['1', '-2', '9223372036854775807']);
+		equal(IntegerArray.fromBuffer(buffer, 24), []);
+		expect(() => IntegerArray.fromBuffer(buffer, 0, 4)).to.throw(RangeError);
+		expect(() => array.writeTo(buffer, 7)).to.throw(RangeError);
+		expect(() => IntegerArray.fromBuffer(buffer, 0, -1)).to.throw(TypeError);
+	});
+	specify('Integer.Array.fromVarints() and Integer.Array#writeVarints()', function () {
+		const values = [];
+		for (let i = 0; i < 100; ++i) values.push(i % 7 === 0 ? -i * 1e12 : i);
+		values.push('-9223372036854775808', '9223372036854775807');
+		const array = IntegerArray.from(values);
+		const expected = values.map(String);
+		for (const options of [undefined, { zigzag: true }]) {
+			const buffer = Buffer.alloc(2000);
+			const end = array.writeVarints(buffer, 3, options);
+			let offset = 3;
+			for (const value of expected) {
+				expect(Integer.fromVarint(buffer, offset, options).toString()).to.equal(value);
+				offset += Integer.varintLength(buffer, offset);
+			}
+			expect(end).to.equal(offset);
+			equal(IntegerArray.fromVarints(buffer.slice(0, end), 3, undefined, options), expected);
+			equal(IntegerArray.fromVarints(buffer, 3, 50, options), expected.slice(0, 50));
+			expect(() => IntegerArray.fromVarints(buffer.slice(0, end - 1), 3, undefined, options)).to.throw(RangeError, 'Truncated varint at index 101');
+			const small = Buffer.alloc(end - 4, 0xff);
+			expect(() => array.writeVarints(small, 0, options)).to.throw(RangeError, 'The buffer is too small');
+			expect(small.equals(Buffer.alloc(end - 4, 0xff))).to.be.true;
+		}
+		equal(IntegerArray.fromVarints(Buffer.alloc(20)), new Array(20).fill('0'));
+		expect(() => IntegerArray.fromVarints(Buffer.from([1, 0x80]), 0, 2)).to.throw(RangeError, 'Truncated varint at index 1');
+		expect(() => IntegerArray.fromVarints(Buffer.from([1, 2, 3]), 0, 4)).to.throw(RangeError, 'The buffer is too small');
+		expect(() => IntegerArray.fromVarints(Buffer.from([1, 2, 3]), 0, 4294967295)).to.throw(RangeError, 'The buffer is too small');
+		expect(() => IntegerArray.fromVarints(Buffer.alloc(11, 0x80))).to.throw(RangeError, 'Malformed varint at index 0');
+	});
+	specify('Integer.Array#writeTo() and #writeVarints() read the elements after the options', function () {
+		if (parseInt(process.versions.node, 10) < 12) return;
+		const { MessageChannel } = require('worker_threads');
+		const detach = (array) => {
+			const { port1 } = new MessageChannel();
+			port1.postMessage(null, [array.asBigInt64Array().buffer]);
+			port1.close();
+		};
+		const array = IntegerArray.from([1, 2, 3]);
+		expect(array.writeTo(Buffer.alloc(24), 0, { get endian() { detach(array); return 'big'; } })).to.equal(0);
+		const other = IntegerArray.from([1, 2, 3]);
+		expect(other.writeVarints(Buffer.alloc(3), 1, { get zigzag() { detach(other); return true; } })).to.equal(1);
+	});
+	specify('Integer.Array#writeText()', function () {
+		const array = IntegerArray.from([1, -20, '9223372036854775807']);
+		const buffer = Buffer.alloc(32);
+		expect(array.writeText(buffer)).to.equal(25);
+		expect(buffer.toString('latin1', 0, 25)).to.equal('1,-20,9223372036854775807');
+		expect(array.writeText(buffer, 2, '\n')).to.equal(27);
+		expect(buffer.toString('latin1', 2, 27)).to.equal('1\n-20\n9223372036854775807');
+		expect(() => array.writeText(buffer, 8)).to.throw(RangeError);
+		expect(() => array.writeText([])).to.throw(TypeError);
+	});
+});
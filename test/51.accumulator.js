@@ -0,0 +1,84 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+const Accumulator = Integer.Accumulator;
+
+function equal(accumulator, b) {
+	expect(accumulator).to.be.an.instanceof(Accumulator);
+	const int = accumulator.toInteger();
+	expect(int).to.be.an.instanceof(Integer);
+	expect(int.toString()).to.equal(b);
+}
+
+describe('Integer.Accumulator', function () {
+	it('should be constructable from an initial value', function () {
+		equal(new Accumulator(), '0');
+		equal(new Accumulator(5), '5');
+		equal(new Accumulator('-9223372036854775808'), '-9223372036854775808');
+		equal(new Accumulator(Integer(7), { overflow: 'wrap' }), '7');
+		expect(() => Accumulator(1)).to.throw(TypeError);
+		expect(() => new Accumulator(1.5)).to.throw(TypeError);
+		expect(() => new Accumulator(0, 'wrap')).to.throw(TypeError);
+		expect(() => new Accumulator(0, { overflow: 'clamp' })).to.throw(TypeError);
+	});
+	it('should update its value in place', function () {
+		const acc = new Accumulator(10);
+		expect(acc.add(5)).to.equal(acc);
+		equal(acc, '15');
+		equal(acc.subtract('20'), '-5');
+		equal(acc.multiply(Integer(-3)), '15');
+		equal(acc.min(20), '15');
+		equal(acc.min(-2), '-2');
+		equal(acc.max(-7), '-2');
+		equal(acc.max(100), '100');
+		equal(acc.reset(), '0');
+		equal(acc.reset(42), '42');
+		expect(() => acc.add()).to.throw(TypeError);
+		expect(() => acc.add(1.5)).to.throw(TypeError);
+		expect(() => Accumulator.prototype.add.call(Integer(1), 1)).to.throw(TypeError);
+	});
+	it('should throw on overflow by default, leaving the value unchanged', function () {
+		const acc = new Accumulator(Integer.MAX_VALUE);
+		expect(() => acc.add(1)).to.throw(RangeError, 'Integer overflow');
+		expect(() => acc.multiply(2)).to.throw(RangeError, 'Integer overflow');
+		expect(() => acc.subtract(-1)).to.throw(RangeError, 'Integer overflow');
+		equal(acc, '9223372036854775807');
+		equal(acc.add(-1).add(1), '9223372036854775807');
+	});
+	it('should saturate or wrap on overflow when asked to', function () {
+		const saturate = { overflow: 'saturate' };
+		equal(new Accumulator(Integer.MAX_VALUE, saturate).add(1), '9223372036854775807');
+		equal(new Accumulator(Integer.MIN_VALUE, saturate).add(-1), '-9223372036854775808');
+		equal(new Accumulator(Integer.MIN_VALUE, saturate).subtract(1), '-9223372036854775808');
+		equal(new Accumulator(Integer.MAX_VALUE, saturate).subtract(-1), '9223372036854775807');
+		equal(new Accumulator(Integer.MAX_VALUE, saturate).multiply(-2), '-9223372036854775808');
+		equal(new Accumulator(Integer.MIN_VALUE, saturate).multiply(-1), '9223372036854775807');
+		equal(new Accumulator(Integer.MAX_VALUE, saturate).add(1).add(-7), '9223372036854775800');
+		const wrap = { overflow: 'wrap' };
+		equal(new Accumulator(Integer.MAX_VALUE, wrap).add(1), '-9223372036854775808');
+		equal(new Accumulator(Integer.MIN_VALUE, wrap).subtract(1), '9223372036854775807');
+		equal(new Accumulator(Integer.MIN_VALUE, wrap).multiply(-1), '-9223372036854775808');
+		equal(new Accumulator('4294967296', wrap).multiply('4294967296'), '0');
+	});
+	specify('Integer.Accumulator#addAll()', function () {
+		const values = [];
+		for (let i = 0; i < 1000; ++i) values.push(i);
+		const bigints = new BigInt64Array(values.map(BigInt));
+		equal(new Accumulator(1).addAll(values), '499501');
+		equal(new Accumulator(1).addAll(bigints), '499501');
+		equal(new Accumulator(1).addAll(Integer.Array.from(values)), '499501');
+		equal(new Accumulator().addAll([1, '2', Integer(3)]), '6');
+		expect(() => new Accumulator().addAll('123')).to.throw(TypeError);
+		expect(() => new Accumulator().addAll([1, 1.5])).to.throw(TypeError);
+
+		bigints[700] = 9223372036854775807n;
+		values[700] = Integer.MAX_VALUE;
+		for (const input of [values, bigints]) {
+			const acc = new Accumulator(5);
+			expect(() => acc.addAll(input)).to.throw(RangeError, 'Integer overflow at index 700');
+			equal(acc, '5');
+			equal(new Accumulator(0, { overflow: 'saturate' }).addAll(input), '9223372036854775807');
+			equal(new Accumulator(0, { overflow: 'wrap' }).addAll(input), String(BigInt.asIntN(64, 9223372036854775807n + BigInt(999 * 1000 / 2 - 700))));
+		}
+	});
+});
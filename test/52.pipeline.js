@@ -0,0 +1,95 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+const Pipeline = Integer.Pipeline;
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(b);
+}
+
+describe('Integer.compile()', function () {
+	it('should return a Pipeline', function () {
+		expect(Integer.compile([])).to.be.an.instanceof(Pipeline);
+		expect(new Pipeline([['add', 1]])).to.be.an.instanceof(Pipeline);
+		expect(() => Pipeline([])).to.throw(TypeError);
+	});
+	it('should apply every operation in order', function () {
+		const mask = Integer.fromString('ffff', 16);
+		const pipeline = Integer.compile([['multiply', 2654435761], ['add', '12345'], ['shiftRight', 3], ['and', mask]]);
+		for (const x of [0, 1, -1, 77, 123456789, -987654321]) {
+			equal(pipeline.apply(x), Integer(x).multiply(2654435761).add('12345').shiftRight(3).and(mask).toString());
+		}
+		equal(Integer.compile([]).apply(5), '5');
+		equal(Integer.compile(['not', 'negate', ['xor', -1], ['shl', 66], ['or', Integer(1)]]).apply(3), '-19');
+		equal(Integer.compile([['subtract', 10], ['divide', 3], ['modulo', 4], ['mul', -1]]).apply(100), '-2');
+	});
+	it('should support the other operations that return an Integer', function () {
+		const pipeline = Integer.compile(['abs', ['pow', 3], ['gcd', 360], ['lcm', -84], 'sqrt', ['max', 10], ['min', 20]]);
+		for (const x of [0, 1, -2, 6, -30, 1000, -123456]) {
+			const expected = Integer(x).abs().pow(3).gcd(360).lcm(-84).sqrt();
+			equal(pipeline.apply(x), String(Math.min(Math.max(expected.toNumber(), 10), 20)));
+		}
+		equal(Integer.compile(['absoluteValue']).apply(-5), '5');
+		equal(Integer.compile([['max', '-9223372036854775808'], ['min', 0]]).apply(7), '0');
+		expect(() => Integer.compile(['abs']).apply(Integer.MIN_VALUE)).to.throw(RangeError, 'Integer overflow');
+		expect(() => Integer.compile([['pow', 63]]).apply(2)).to.throw(RangeError, 'Integer overflow');
+		expect(() => Integer.compile([['gcd', 0]]).apply(Integer.MIN_VALUE)).to.throw(RangeError, 'Integer overflow');
+		expect(() => Integer.compile([['lcm', 2]]).apply(Integer.MAX_VALUE)).to.throw(RangeError, 'Integer overflow');
+		expect(() => Integer.compile(['sqrt']).apply(-1)).to.throw(RangeError, 'Cannot take the square root of a negative number');
+		const values = [4, -9, 16, Integer.MIN_VALUE, 25];
+		expect(() => Integer.compile(['abs', 'sqrt']).applyAll(values)).to.throw(RangeError, 'Integer overflow at index 3');
+		expect(Integer.compile(['abs', 'sqrt']).applyAll(values.slice(0, 3)).toArray().map(String)).to.deep.equal(['2', '3', '4']);
+	});
+	it('should throw when the operations are invalid', function () {
+		expect(() => Integer.compile()).to.throw(TypeError);
+		expect(() => Integer.compile('add')).to.throw(TypeError);
+		expect(() => Integer.compile([['mulDiv', 2]])).to.throw(TypeError, 'Unknown operation: mulDiv');
+		expect(() => Integer.compile([['pow', -1]])).to.throw(RangeError, 'Exponent must be non-negative');
+		expect(() => Integer.compile([[1, 2]])).to.throw(TypeError);
+		expect(() => Integer.compile(['add'])).to.throw(TypeError, 'Missing operand');
+		expect(() => Integer.compile([['not', 1]])).to.throw(TypeError, 'Unexpected operand');
+		expect(() => Integer.compile([['add', 1.5]])).to.throw(TypeError);
+		expect(() => Integer.compile([['shiftLeft', -1]])).to.throw(TypeError);
+		expect(() => Integer.compile([['add', '9223372036854775808']])).to.throw(RangeError);
+	});
+	it('should check for overflow at each step', function () {
+		const pipeline = Integer.compile([['add', 1], ['multiply', 2], ['subtract', 1]]);
+		equal(pipeline.apply('4611686018427387902'), '9223372036854775805');
+		expect(() => pipeline.apply('4611686018427387903')).to.throw(RangeError, 'Integer overflow');
+		expect(() => pipeline.apply(Integer.MAX_VALUE)).to.throw(RangeError, 'Integer overflow');
+		expect(() => Integer.compile([['divide', 0]]).apply(1)).to.throw(RangeError, 'Divide by zero');
+		expect(() => Integer.compile(['negate']).apply(Integer.MIN_VALUE)).to.throw(RangeError, 'Integer overflow');
+		expect(() => pipeline.apply()).to.throw(TypeError);
+		expect(() => pipeline.apply(1.5)).to.throw(TypeError);
+	});
+	specify('Pipeline#applyAll()', function () {
+		const pipeline = Integer.compile([['multiply', 3], ['add', -7], ['shiftRight', 1], 'not']);
+		const values = [];
+		for (let i = 0; i < 1000; ++i) values.push(i * 7919 - 500000);
+		const expected = values.map(x => pipeline.apply(x).toString());
+		for (const input of [values, new BigInt64Array(values.map(BigInt)), Integer.Array.from(values)]) {
+			const result = pipeline.applyAll(input);
+			expect(result).to.be.an.instanceof(Integer.Array);
+			expect(result.toArray().map(String)).to.deep.equal(expected);
+		}
+		expect(Integer.compile([]).applyAll([1, 2]).toArray().map(String)).to.deep.equal(['1', '2']);
+		expect(pipeline.applyAll([]).length).to.equal(0);
+		expect(() => pipeline.applyAll('123')).to.throw(TypeError);
+		expect(() => pipeline.applyAll([1, 1.5])).to.throw(TypeError);
+	});
+	it('should report the first value to overflow in applyAll()', function () {
+		const values = [];
+		for (let i = 0; i < 1000; ++i) values.push(i);
+		values[700] = '4611686018427387904';
+		values[600] = '-4611686018427387905';
+		const pipeline = Integer.compile([['add', 1], ['multiply', 2]]);
+		expect(() => pipeline.applyAll(values)).to.throw(RangeError, 'Integer overflow at index 700');
+		values[600] = Integer.MAX_VALUE;
+		expect(() => pipeline.applyAll(Integer.Array.from(values))).to.throw(RangeError, 'Integer overflow at index 600');
+		values[10] = '4611686018427387904';
+		values[20] = Integer.MAX_VALUE;
+		expect(() => pipeline.applyAll(values)).to.throw(RangeError, 'Integer overflow at index 10');
+		expect(() => Integer.compile([['modulo', 0]]).applyAll([1])).to.throw(RangeError, 'Divide by zero at index 0');
+	});
+});
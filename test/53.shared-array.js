@@ -0,0 +1,112 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+const SharedArray = Integer.SharedArray;
+const threads = parseInt(process.versions.node) >= 12 ? require('worker_threads') : null;
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(b);
+}
+
+const ITERATIONS = 2000;
+const HEADROOM = 1000;
+
+if (!threads || threads.isMainThread) {
+	describe('Integer.SharedArray', function () {
+		it('should be constructable from a length or SharedArrayBuffer', function () {
+			const array = new SharedArray(3);
+			expect(array.length).to.equal(3);
+			expect(array.buffer).to.be.an.instanceof(SharedArrayBuffer);
+			expect(array.buffer.byteLength).to.equal(24);
+			equal(array.load(2), '0');
+			array.store(1, '-9223372036854775808');
+			const view = new SharedArray(array.buffer, 8, 1);
+			expect(view.length).to.equal(1);
+			equal(view.load(0), '-9223372036854775808');
+			expect(new SharedArray(array.buffer, 16).length).to.equal(1);
+			expect(new SharedArray().length).to.equal(0);
+			expect(() => SharedArray(1)).to.throw(TypeError);
+			expect(() => new SharedArray(new ArrayBuffer(8))).to.throw(TypeError);
+			expect(() => new SharedArray(array.buffer, 4)).to.throw(RangeError);
+			expect(() => new SharedArray(array.buffer, 32)).to.throw(RangeError);
+			expect(() => new SharedArray(array.buffer, 8, 3)).to.throw(RangeError);
+			try { new SharedArrayBuffer(4294967295 * 8); } catch (_) {
+				expect(() => new SharedArray(4294967295)).to.throw(RangeError);
+			}
+		});
+		it('should share its elements with other views of the buffer', function () {
+			const array = new SharedArray(2);
+			array.store(0, Integer.MAX_VALUE);
+			array.store(1, -2);
+			if (typeof BigInt64Array === 'function') {
+				const bigints = new BigInt64Array(array.buffer);
+				expect(bigints[0]).to.equal(BigInt('9223372036854775807'));
+				expect(bigints[1]).to.equal(BigInt(-2));
+				bigints[1] = BigInt(77);
+				equal(array.load(1), '77');
+			}
+		});
+		it('should update elements atomically, returning the previous value', function () {
+			const array = new SharedArray(1);
+			expect(array.store(0, 10)).to.equal(undefined);
+			equal(array.exchange(0, '20'), '10');
+			equal(array.compareExchange(0, 5, 30), '20');
+			equal(array.load(0), '20');
+			equal(array.compareExchange(0, 20, Integer(30)), '20');
+			equal(array.load(0), '30');
+			equal(array.fetchAdd(0, 12), '30');
+			equal(array.fetchSub(0, 50), '42');
+			equal(array.load(0), '-8');
+			expect(() => array.load(1)).to.throw(RangeError, 'Index is out of bounds');
+			expect(() => array.load(-1)).to.throw(TypeError);
+			expect(() => array.store(0)).to.throw(TypeError);
+			expect(() => array.fetchAdd(0, 1.5)).to.throw(TypeError);
+			expect(() => SharedArray.prototype.load.call(new Integer.Array(1), 0)).to.throw(TypeError);
+		});
+		it('should throw on overflow without writing anything', function () {
+			const array = new SharedArray(2);
+			array.store(0, Integer.MAX_VALUE);
+			array.store(1, Integer.MIN_VALUE);
+			expect(() => array.fetchAdd(0, 1)).to.throw(RangeError, 'Integer overflow');
+			expect(() => array.fetchSub(1, 1)).to.throw(RangeError, 'Integer overflow');
+			expect(() => array.fetchSub(0, -1)).to.throw(RangeError, 'Integer overflow');
+			equal(array.load(0), '9223372036854775807');
+			equal(array.load(1), '-9223372036854775808');
+		});
+		if (threads) {
+			it('should be safe to update from many workers at once', function () {
+				const array = new SharedArray(3);
+				array.store(2, Integer.MAX_VALUE.subtract(HEADROOM));
+				const workers = [];
+				for (let i = 0; i < 4; ++i) {
+					workers.push(new Promise((resolve, reject) => {
+						const worker = new threads.Worker(__filename, { workerData: array.buffer });
+						worker.on('error', reject);
+						worker.on('message', resolve);
+					}));
+				}
+				return Promise.all(workers).then((results) => {
+					equal(array.load(0), String(4 * ITERATIONS));
+					equal(array.load(1), String(-4 * ITERATIONS));
+					equal(array.load(2), '9223372036854775807');
+					expect(results.reduce((a, b) => a + b)).to.equal(HEADROOM);
+				});
+			});
+		}
+	});
+} else {
+	const array = new SharedArray(threads.workerData);
+	let added = 0;
+	for (let i = 0; i < ITERATIONS; ++i) {
+		array.fetchAdd(0, 1);
+		array.fetchSub(1, 1);
+		try {
+			array.fetchAdd(2, 1);
+			added += 1;
+		} catch (err) {
+			if (!(err instanceof RangeError)) throw err;
+		}
+	}
+	threads.parentPort.postMessage(added);
+}
@@ -0,0 +1,170 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+function equal(a, b) {
+	expect(a).to.be.an.instanceof(Integer);
+	expect(a.toString()).to.equal(b);
+}
+
+function bytes(array) {
+	const view = array instanceof Integer.Array ? array.asBigInt64Array() : array;
+	return Buffer.from(view.buffer, view.byteOffset, view.byteLength);
+}
+
+function random(length, seed, range) {
+	const array = new Integer.Array(length);
+	let x = seed;
+	const next = () => (x = Math.imul(x, 1103515245) + 12345 | 0);
+	for (let i = 0; i < length; ++i) {
+		const value = Integer.fromBits(next(), next());
+		array.set(i, range ? value.modulo(range) : value);
+	}
+	return array;
+}
+
+function rejects(promise, type, message) {
+	return promise.then(() => { throw new Error('Expected the promise to be rejected'); }, (err) => {
+		expect(err).to.be.an.instanceof(type);
+		expect(err.message).to.equal(message);
+	});
+}
+
+describe('Integer.Array batch operations', function () {
+	const large = random(300000, 7, 1000000);
+	const values = [];
+	for (let i = 0; i < 1000; ++i) values.push(i * 7919 - 400000);
+	const small = Integer.Array.from(values);
+
+	it('should return promises of the same results as the synchronous methods', function () {
+		const promise = small.sumAsync();
+		expect(promise).to.be.an.instanceof(Promise);
+		return Promise.all([
+			promise, small.minAsync(), small.maxAsync(),
+			large.sumAsync({ concurrency: 4 }), large.minAsync({ concurrency: 4 }), large.maxAsync({ concurrency: 3 }),
+			new Integer.Array(0).sumAsync(), new Integer.Array(0).minAsync(), new Integer.Array(0).maxAsync(),
+		]).then((results) => {
+			equal(results[0], small.sum().toString());
+			equal(results[1], small.min().toString());
+			equal(results[2], small.max().toString());
+			equal(results[3], large.sum().toString());
+			equal(results[4], large.min().toString());
+			equal(results[5], large.max().toString());
+			equal(results[6], '0');
+			expect(results[7]).to.equal(undefined);
+			expect(results[8]).to.equal(undefined);
+		});
+	});
+	it('should reject with the index of the first overflow, just like sum()', function () {
+		const array = new Integer.Array(300000);
+		array.set(200000, Integer.MAX_VALUE);
+		array.set(200001, 1);
+		array.set(200002, -10);
+		const cases = [];
+		for (const concurrency of [1, 4]) {
+			cases.push(rejects(array.sumAsync({ concurrency }), RangeError, 'Integer overflow at index 200001'));
+		}
+		// The total fits, but the running total overflows along the way.
+		const prefix = new Integer.Array(300000);
+		prefix.set(10, 5);
+		prefix.set(150000, Integer.MAX_VALUE);
+		prefix.set(299999, Integer.MIN_VALUE);
+		expect(() => prefix.sum()).to.throw(RangeError, 'Integer overflow at index 150000');
+		cases.push(rejects(prefix.sumAsync({ concurrency: 4 }), RangeError, 'Integer overflow at index 150000'));
+		// Each part overflows on its own, but the running total never does.
+		const parts = new Integer.Array(300000);
+		parts.set(0, Integer.MIN_VALUE.add(1));
+		parts.set(100000, Integer.MAX_VALUE);
+		parts.set(100001, 10);
+		cases.push(parts.sumAsync({ concurrency: 4 }).then(sum => equal(sum, '10')));
+		return Promise.all(cases);
+	});
+	it('should sort and deduplicate into a new array', function () {
+		const extremes = Integer.Array.from([5, Integer.MIN_VALUE, -1, 0, Integer.MAX_VALUE, -1, 5, '-4294967296', '4294967296', 1]);
+		const wide = random(50000, 3);
+		return Promise.all([
+			extremes.sortAsync(), extremes.uniqueAsync(), large.sortAsync(), large.uniqueAsync(), wide.sortAsync(),
+			new Integer.Array(0).sortAsync(), Integer.Array.from([3, 3, 3]).uniqueAsync(),
+		]).then((results) => {
+			expect(results[0].toArray().map(String)).to.deep.equal(['-9223372036854775808', '-4294967296', '-1', '-1', '0', '1', '5', '5', '4294967296', '9223372036854775807']);
+			expect(results[1].toArray().map(String)).to.deep.equal(['-9223372036854775808', '-4294967296', '-1', '0', '1', '5', '4294967296', '9223372036854775807']);
+			expect(extremes.get(0).toString()).to.equal('5');
+			const sorted = large.asBigInt64Array().slice().sort((a, b) => (a < b ? -1 : a > b ? 1 : 0));
+			expect(bytes(results[2]).equals(bytes(sorted))).to.be.true;
+			const unique = sorted.filter((x, i) => i === 0 || x !== sorted[i - 1]);
+			expect(bytes(results[3]).equals(bytes(unique))).to.be.true;
+			const wideSorted = wide.asBigInt64Array().slice().sort((a, b) => (a < b ? -1 : a > b ? 1 : 0));
+			expect(bytes(results[4]).equals(bytes(wideSorted))).to.be.true;
+			expect(results[5].length).to.equal(0);
+			expect(results[6].toArray().map(String)).to.deep.equal(['3']);
+		});
+	});
+	it('should keep the input alive if it is transferred before the promise settles', function () {
+		// Older versions of V8 cannot share the memory of an ArrayBuffer.
+		if (parseInt(process.versions.v8, 10) < 8) return;
+		const { MessageChannel } = require('worker_threads');
+		const array = random(300000, 11);
+		const buffer = array.asBigInt64Array().buffer;
+		const promise = array.sortAsync();
+		const channel = new MessageChannel();
+		channel.port1.postMessage(buffer, [buffer]);
+		channel.port1.close();
+		expect(array.length).to.equal(0);
+		return promise.then((result) => {
+			expect(result.length).to.equal(300000);
+		});
+	});
+	it('should read the elements after the options', function () {
+		if (parseInt(process.versions.node, 10) < 12) return;
+		const { MessageChannel } = require('worker_threads');
+		return Promise.all(['sumAsync', 'minAsync', 'maxAsync'].map((method) => {
+			const array = random(300000, 13);
+			const options = { get concurrency() {
+				const { port1 } = new MessageChannel();
+				port1.postMessage(null, [array.asBigInt64Array().buffer]);
+				port1.close();
+				return 4;
+			} };
+			return array[method](options);
+		})).then((results) => {
+			equal(results[0], '0');
+			expect(results[1]).to.equal(undefined);
+			expect(results[2]).to.equal(undefined);
+		});
+	});
+	it('should throw synchronously when the arguments are invalid', function () {
+		expect(() => small.sumAsync(4)).to.throw(TypeError);
+		expect(() => small.sumAsync({ concurrency: 0 })).to.throw(RangeError);
+		expect(() => small.minAsync({ concurrency: 65 })).to.throw(RangeError);
+		expect(() => small.maxAsync({ concurrency: 1.5 })).to.throw(TypeError);
+		expect(() => Integer.Array.prototype.sortAsync.call(Integer(1))).to.throw(TypeError);
+	});
+});
+
+describe('Integer.parseManyAsync()', function () {
+	it('should return a promise of the same result as Integer.parseMany()', function () {
+		const lines = [];
+		for (let i = 0; i < 400000; ++i) lines.push(i % 13 === 0 ? `${i}x` : i % 17 === 0 ? '' : String(i * 99991 - 1e9));
+		const text = Buffer.from(lines.join('\n') + '\n');
+		const expected = Integer.parseMany(text, 10, '\n');
+		const cases = [1, 3, 8].map(concurrency => Integer.parseManyAsync(text, 10, '\n', { concurrency }).then((result) => {
+			expect(Object.keys(result)).to.deep.equal(['values', 'valid', 'errors']);
+			expect(result.values).to.be.an.instanceof(Integer.Array);
+			expect(bytes(result.values).equals(bytes(expected.values))).to.be.true;
+			expect(bytes(result.valid).equals(bytes(expected.valid))).to.be.true;
+			expect(bytes(result.errors).equals(bytes(expected.errors))).to.be.true;
+		}));
+		cases.push(Integer.parseManyAsync(Buffer.from('ff,-10,zz'), 16).then((result) => {
+			expect(result.values.toArray().map(String)).to.deep.equal(['255', '-16', '0']);
+			expect(Array.from(result.valid)).to.deep.equal([3]);
+			expect(Array.from(result.errors)).to.deep.equal([0, 0, 5]);
+		}));
+		cases.push(Integer.parseManyAsync(new Uint8Array(0)).then(result => expect(result.values.length).to.equal(0)));
+		return Promise.all(cases);
+	});
+	it('should throw synchronously when the arguments are invalid', function () {
+		expect(() => Integer.parseManyAsync(['1'])).to.throw(TypeError);
+		expect(() => Integer.parseManyAsync(Buffer.from('1'), 37)).to.throw(RangeError);
+		expect(() => Integer.parseManyAsync(Buffer.from('1'), 10, '\n', { concurrency: 0 })).to.throw(RangeError);
+	});
+});
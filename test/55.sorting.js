@@ -0,0 +1,125 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+function strings(array) {
+	expect(array).to.be.an.instanceof(Integer.Array);
+	return array.toArray().map(String);
+}
+
+function random(length, seed, range) {
+	const array = new Integer.Array(length);
+	let x = seed;
+	const next = () => (x = Math.imul(x, 1103515245) + 12345 | 0);
+	for (let i = 0; i < length; ++i) {
+		const value = Integer.fromBits(next(), next());
+		array.set(i, range ? value.modulo(range) : value);
+	}
+	return array;
+}
+
+// Transfers the buffer away, leaving it detached (where worker_threads exists).
+function detach(buffer) {
+	const { port1 } = new (require('worker_threads').MessageChannel)();
+	port1.postMessage(null, [buffer]);
+	port1.close();
+}
+
+function compare(a, b) {
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+describe('Integer.Array sorting', function () {
+	const extremes = Integer.Array.from([5, Integer.MIN_VALUE, -1, 0, Integer.MAX_VALUE, -1, 5, '-4294967296', '4294967296', 1]);
+
+	it('should sort into a new array, in either direction', function () {
+		expect(strings(extremes.sort())).to.deep.equal(['-9223372036854775808', '-4294967296', '-1', '-1', '0', '1', '5', '5', '4294967296', '9223372036854775807']);
+		expect(strings(extremes.sort({ descending: true }))).to.deep.equal(['9223372036854775807', '4294967296', '5', '5', '1', '0', '-1', '-1', '-4294967296', '-9223372036854775808']);
+		expect(extremes.get(0).toString()).to.equal('5');
+		expect(strings(new Integer.Array(0).sort())).to.deep.equal([]);
+		for (const array of [random(5000, 3), random(5000, 9, 100)]) {
+			const sorted = array.asBigInt64Array().slice().sort(compare);
+			expect(array.sort().asBigInt64Array()).to.deep.equal(sorted);
+			expect(array.sort({ descending: true }).asBigInt64Array()).to.deep.equal(sorted.reverse());
+		}
+	});
+	it('should return the indices of a stable sort', function () {
+		const indices = extremes.argsort();
+		expect(indices).to.be.an.instanceof(Uint32Array);
+		expect(Array.from(indices)).to.deep.equal([1, 7, 2, 5, 3, 9, 0, 6, 8, 4]);
+		expect(Array.from(extremes.argsort({ descending: true }))).to.deep.equal([4, 8, 0, 6, 9, 3, 2, 5, 7, 1]);
+		for (const array of [random(5000, 5, 50), random(100, 5, 10)]) {
+			const bigints = array.asBigInt64Array();
+			const expected = Array.from(bigints.keys()).sort((a, b) => compare(bigints[a], bigints[b]) || a - b);
+			expect(Array.from(array.argsort())).to.deep.equal(expected);
+			const descending = Array.from(bigints.keys()).sort((a, b) => compare(bigints[b], bigints[a]) || a - b);
+			expect(Array.from(array.argsort({ descending: true }))).to.deep.equal(descending);
+		}
+	});
+	it('should return the sorted distinct values', function () {
+		expect(strings(extremes.unique())).to.deep.equal(['-9223372036854775808', '-4294967296', '-1', '0', '1', '5', '4294967296', '9223372036854775807']);
+		expect(strings(Integer.Array.from([3, 3, 3]).unique())).to.deep.equal(['3']);
+	});
+	it('should throw when the options are invalid', function () {
+		expect(() => extremes.sort(true)).to.throw(TypeError);
+		expect(() => extremes.argsort({ descending: 1 })).to.throw(TypeError);
+		expect(() => Integer.Array.prototype.sort.call([1, 2])).to.throw(TypeError);
+	});
+	it('should read the elements after the options', function () {
+		if (parseInt(process.versions.node, 10) < 12) return;
+		for (const method of ['sort', 'argsort']) {
+			const array = Integer.Array.from([3, 1, 2]);
+			const options = { get descending() { detach(array.asBigInt64Array().buffer); return false; } };
+			expect(array[method](options).length).to.equal(0);
+		}
+	});
+});
+
+describe('Integer.Array searching', function () {
+	const sorted = Integer.Array.from([-10, -10, 0, 3, 3, 3, 8, Integer.MAX_VALUE]);
+
+	it('should find values in a sorted array', function () {
+		expect([-10, 0, 8, Integer.MAX_VALUE].map(x => sorted.binarySearch(x))).to.deep.equal([0, 2, 6, 7]);
+		expect([3, '3', Integer(3)].map(x => sorted.binarySearch(x))).to.deep.equal([3, 3, 3]);
+		expect([-11, 1, 9, Integer.MIN_VALUE].map(x => sorted.binarySearch(x))).to.deep.equal([-1, -1, -1, -1]);
+		expect(new Integer.Array(0).binarySearch(0)).to.equal(-1);
+	});
+	it('should return the lower and upper bounds of a value', function () {
+		expect([-11, -10, 1, 3, 8, Integer.MAX_VALUE].map(x => sorted.lowerBound(x))).to.deep.equal([0, 0, 3, 3, 6, 7]);
+		expect([-11, -10, 1, 3, 8, Integer.MAX_VALUE].map(x => sorted.upperBound(x))).to.deep.equal([0, 2, 3, 6, 7, 8]);
+	});
+	it('should throw when the value is invalid', function () {
+		expect(() => sorted.binarySearch()).to.throw(TypeError);
+		expect(() => sorted.lowerBound(1.5)).to.throw(TypeError);
+		expect(() => sorted.upperBound('abc')).to.throw(TypeError);
+	});
+});
+
+describe('Integer.Array set operations', function () {
+	const a = Integer.Array.from([-5, 1, 2, 2, 4, 9, '9223372036854775807']);
+	const b = Integer.Array.from([1, 2, 3, 4, 10]);
+
+	it('should merge sorted arrays', function () {
+		expect(strings(a.intersection(b))).to.deep.equal(['1', '2', '4']);
+		expect(strings(a.union(b))).to.deep.equal(['-5', '1', '2', '2', '3', '4', '9', '10', '9223372036854775807']);
+		expect(strings(a.difference(b))).to.deep.equal(['-5', '2', '9', '9223372036854775807']);
+		expect(strings(b.difference(a.asBigInt64Array()))).to.deep.equal(['3', '10']);
+		expect(strings(a.intersection(new Integer.Array(0)))).to.deep.equal([]);
+		expect(a.union(new Integer.Array(0)).length).to.equal(a.length);
+	});
+	it('should agree with the unique values of large arrays', function () {
+		const x = random(20000, 1, 30000).unique();
+		const y = random(20000, 2, 30000).unique();
+		const inY = new Set(y.asBigInt64Array());
+		const xs = Array.from(x.asBigInt64Array());
+		expect(Array.from(x.intersection(y).asBigInt64Array())).to.deep.equal(xs.filter(v => inY.has(v)));
+		expect(Array.from(x.difference(y).asBigInt64Array())).to.deep.equal(xs.filter(v => !inY.has(v)));
+		const union = Array.from(new Set(xs.concat(Array.from(y.asBigInt64Array())))).sort(compare);
+		expect(Array.from(x.union(y).asBigInt64Array())).to.deep.equal(union);
+	});
+	it('should throw when the argument is not an array of 64-bit integers', function () {
+		expect(() => a.union()).to.throw(TypeError);
+		expect(() => a.union([1, 2])).to.throw(TypeError);
+		expect(() => a.intersection(new Float64Array(2))).to.throw(TypeError);
+	});
+});
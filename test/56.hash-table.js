@@ -0,0 +1,146 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+
+function sorted(array) {
+	return array.toArray().map(String).sort();
+}
+
+describe('Integer#hash()', function () {
+	it('should return the same 32-bit integer for equal values', function () {
+		const hash = Integer('123456789012345').hash();
+		expect(typeof hash).to.equal('number');
+		expect(hash | 0).to.equal(hash);
+		expect(Integer.fromString('123456789012345').hash()).to.equal(hash);
+		expect(Integer(123456789012346).hash()).to.not.equal(hash);
+		expect(Integer.MIN_VALUE.hash() | 0).to.equal(Integer.MIN_VALUE.hash());
+	});
+	it('should spread consecutive values over every bit', function () {
+		const seen = new Set();
+		for (let i = 0; i < 1000; ++i) seen.add(Integer(i).hash() & 0xffff);
+		expect(seen.size > 950).to.be.true;
+	});
+});
+
+describe('Integer.Map', function () {
+	it('should store values by integer key', function () {
+		const map = new Integer.Map();
+		const value = {};
+		expect(map.size).to.equal(0);
+		expect(map.set(5, value)).to.equal(map);
+		expect(map.get('5')).to.equal(value);
+		expect(map.get(Integer(5))).to.equal(value);
+		expect(map.has(5)).to.be.true;
+		expect(map.has(6)).to.be.false;
+		expect(map.get(6)).to.equal(undefined);
+		map.set(Integer.MIN_VALUE, 'min').set(Integer.MAX_VALUE, 'max').set(0, null).set('5', 'five');
+		expect(map.size).to.equal(4);
+		expect(map.get('-9223372036854775808')).to.equal('min');
+		expect(map.get(Integer.MAX_VALUE)).to.equal('max');
+		expect(map.get(0)).to.equal(null);
+		expect(map.get(5)).to.equal('five');
+		expect(map.delete(Integer.MIN_VALUE)).to.be.true;
+		expect(map.delete(Integer.MIN_VALUE)).to.be.false;
+		expect(map.has(Integer.MIN_VALUE)).to.be.false;
+		expect(map.size).to.equal(3);
+		map.clear();
+		expect(map.size).to.equal(0);
+		expect(map.has(5)).to.be.false;
+	});
+	it('should be constructable from [key, value] entries', function () {
+		const map = new Integer.Map([[1, 'a'], ['2', 'b'], [Integer(1), 'c']]);
+		expect(map.size).to.equal(2);
+		expect(map.get(1)).to.equal('c');
+		expect(map.get(2)).to.equal('b');
+		expect(() => new Integer.Map([1])).to.throw(TypeError, 'Expected an entry to be a [key, value] array at index 0');
+		expect(() => new Integer.Map([[1.5, 'a']])).to.throw(TypeError);
+		expect(() => Integer.Map()).to.throw(TypeError);
+	});
+	it('should list its keys and values in the same order', function () {
+		const map = new Integer.Map();
+		for (let i = -50; i < 50; ++i) map.set(i * 1000003, i);
+		map.set(Integer.MIN_VALUE, 'min');
+		const keys = map.keys();
+		const values = map.values();
+		expect(keys).to.be.an.instanceof(Integer.Array);
+		expect(keys.length).to.equal(101);
+		expect(values.length).to.equal(101);
+		keys.toArray().forEach((key, i) => expect(map.get(key)).to.equal(values[i]));
+		const visited = [];
+		map.forEach(function (value, key, self) {
+			expect(key).to.be.an.instanceof(Integer);
+			expect(self).to.equal(map);
+			expect(this).to.equal(visited);
+			visited.push(value);
+			map.delete(key);
+		}, visited);
+		expect(visited).to.deep.equal(values);
+		expect(map.size).to.equal(0);
+	});
+	it('should agree with a string-keyed Map over many operations', function () {
+		const map = new Integer.Map();
+		const expected = new Map();
+		let x = 1;
+		for (let i = 0; i < 20000; ++i) {
+			x = Math.imul(x, 1103515245) + 12345 | 0;
+			const key = Integer.fromBits(x & 1023, x >> 30);
+			const name = key.toString();
+			if (x & 0x100000) {
+				map.set(key, i);
+				expected.set(name, i);
+			} else {
+				expect(map.delete(key)).to.equal(expected.delete(name));
+			}
+			if (i % 1000 === 0) expect(map.size).to.equal(expected.size);
+		}
+		expect(map.size).to.equal(expected.size);
+		for (const [name, value] of expected) expect(map.get(name)).to.equal(value);
+		expect(sorted(map.keys())).to.deep.equal(Array.from(expected.keys()).sort());
+	});
+	it('should throw when a key is invalid', function () {
+		const map = new Integer.Map();
+		expect(() => map.get()).to.throw(TypeError);
+		expect(() => map.set(1.5, 'a')).to.throw(TypeError);
+		expect(() => map.has('abc')).to.throw(TypeError);
+		expect(() => map.delete(9007199254740992)).to.throw(RangeError);
+		expect(() => map.forEach()).to.throw(TypeError);
+		expect(() => Integer.Map.prototype.get.call(new Integer.Set(), 1)).to.throw(TypeError);
+	});
+});
+
+describe('Integer.Set', function () {
+	it('should store distinct integer keys', function () {
+		const set = new Integer.Set();
+		expect(set.add(1)).to.equal(set);
+		set.add('1').add(Integer(1)).add(Integer.MIN_VALUE).add(-1);
+		expect(set.size).to.equal(3);
+		expect(set.has(Integer.MIN_VALUE)).to.be.true;
+		expect(set.has(2)).to.be.false;
+		expect(set.delete(1)).to.be.true;
+		expect(set.delete(1)).to.be.false;
+		expect(sorted(set.keys())).to.deep.equal(['-1', '-9223372036854775808']);
+		const keys = [];
+		set.forEach((key, same, self) => {
+			expect(same).to.equal(key);
+			expect(self).to.equal(set);
+			keys.push(key.toString());
+		});
+		expect(keys.sort()).to.deep.equal(['-1', '-9223372036854775808']);
+		set.clear();
+		expect(set.size).to.equal(0);
+	});
+	it('should be constructable from arrays of keys', function () {
+		const array = Integer.Array.from([3, 1, 3, Integer.MIN_VALUE, 2]);
+		expect(sorted(new Integer.Set(array).keys())).to.deep.equal(['-9223372036854775808', '1', '2', '3']);
+		expect(new Integer.Set(array.asBigInt64Array()).size).to.equal(4);
+		expect(new Integer.Set([1, '1', Integer(2)]).size).to.equal(2);
+		const large = new Integer.Array(100000);
+		for (let i = 0; i < large.length; ++i) large.set(i, i * 7 % 50000);
+		const set = new Integer.Set(large);
+		expect(set.size).to.equal(50000);
+		for (let i = 0; i < 50000; i += 997) expect(set.has(i)).to.be.true;
+		expect(set.has(50000)).to.be.false;
+		expect(() => new Integer.Set('123')).to.throw(TypeError);
+		expect(() => new Integer.Set([1, 'x'])).to.throw(TypeError);
+	});
+});
@@ -0,0 +1,147 @@
+'use strict';
+const expect = require('chai').expect;
+const Integer = require('../.');
+const Decimal = Integer.Decimal;
+
+function equal(decimal, b) {
+	expect(Decimal.isInstance(decimal)).to.be.true;
+	expect(decimal.toString()).to.equal(b);
+}
+
+describe('Integer.Decimal', function () {
+	it('should be created from decimals, strings, and integers', function () {
+		equal(Decimal(), '0');
+		equal(Decimal('1234.56'), '1234.56');
+		equal(Decimal('-0.05'), '-0.05');
+		equal(Decimal('  1.50 '), '1.50');
+		equal(Decimal('000.000000000000000001'), '0.000000000000000001');
+		equal(Decimal(7), '7');
+		equal(Decimal(Integer.MIN_VALUE), '-9223372036854775808');
+		equal(Decimal(7n), '7');
+		equal(Decimal('12', 2), '12.00');
+		equal(Decimal('1.999', 2, 'halfExpand'), '2.00');
+		const decimal = Decimal('1.5');
+		expect(Decimal(decimal)).to.equal(decimal);
+		equal(Decimal(decimal, 3), '1.500');
+		expect(() => new Decimal(1)).to.throw(TypeError);
+		expect(() => Decimal(1.5)).to.throw(TypeError);
+		expect(() => Decimal({})).to.throw(TypeError);
+		expect(() => Decimal(1, 19)).to.throw(RangeError);
+		expect(() => Decimal(1, -1)).to.throw(TypeError);
+		expect(() => Decimal(1, 2, 'round')).to.throw(TypeError);
+		expect(() => Decimal(Integer.MAX_VALUE, 1)).to.throw(RangeError);
+	});
+	it('should parse strings with rounding', function () {
+		equal(Decimal.fromString('1.23456', 2), '1.23');
+		equal(Decimal.fromString('1.235', 2, 'halfEven'), '1.24');
+		equal(Decimal.fromString('1.245', 2, 'halfEven'), '1.24');
+		equal(Decimal.fromString('1.2450000000000000000001', 2, 'halfEven'), '1.25');
+		equal(Decimal.fromString('-1.231', 2, 'floor'), '-1.24');
+		equal(Decimal.fromString('-1.239', 2, 'ceil'), '-1.23');
+		equal(Decimal.fromString('0.0000000000000000001', 18, 'expand'), '0.000000000000000001');
+		equal(Decimal.fromString('9223372036854775807.4', 0, 'halfExpand'), '9223372036854775807');
+		equal(Decimal.fromString('-922337203685477580.8', 1), '-922337203685477580.8');
+		expect(() => Decimal.fromString('9223372036854775807.5', 0, 'halfExpand')).to.throw(RangeError);
+		expect(() => Decimal.fromString('9223372036854775808')).to.throw(RangeError);
+		expect(() => Decimal.fromString('99999999999999999999')).to.throw(RangeError);
+		expect(() => Decimal.fromString('92233720368547758.07', 3)).to.throw(RangeError);
+		expect(() => Decimal.fromString('1.0000000000000000001')).to.throw(RangeError);
+		for (const string of ['', '-', '.', '1.', '.5', '1.2.3', '1,5', '1e5', '+1', '- 1', 'abc']) {
+			expect(() => Decimal.fromString(string)).to.throw(TypeError);
+		}
+		expect(() => Decimal.fromString(1.5)).to.throw(TypeError);
+	});
+	it('should be created from a mantissa and a scale', function () {
+		const decimal = Decimal.fromMantissa(-5, 3);
+		equal(decimal, '-0.005');
+		expect(decimal.mantissa).to.be.an.instanceof(Integer);
+		expect(decimal.mantissa.toString()).to.equal('-5');
+		expect(decimal.scale).to.equal(3);
+		equal(Decimal.fromMantissa(Integer.MIN_VALUE, 18), '-9.223372036854775808');
+		expect(() => Decimal.fromMantissa(5)).to.throw(TypeError);
+		expect(() => Decimal.fromMantissa(5, 19)).to.throw(RangeError);
+	});
+	it('should add and subtract exactly', function () {
+		equal(Decimal('0.1').add('0.2'), '0.3');
+		equal(Decimal('0.1').add(Decimal('0.25')), '0.35');
+		equal(Decimal('1').subtract('1.001'), '-0.001');
+		equal(Decimal('19.99').add(5), '24.99');
+		const decimal = Decimal('1.5');
+		expect(decimal.add(0)).to.equal(decimal);
+		expect(() => Decimal(Integer.MAX_VALUE).add(1)).to.throw(RangeError);
+		expect(() => Decimal(Integer.MAX_VALUE).add('0.1')).to.throw(RangeError);
+		expect(() => Decimal(1).add()).to.throw(TypeError);
+	});
+	it('should multiply with rounding', function () {
+		equal(Decimal('19.99').multiply('0.075'), '1.499');
+		equal(Decimal('19.99').multiply('0.075', 2, 'halfEven'), '1.50');
+		equal(Decimal('-1.5').multiply('1.5', 1, 'halfEven'), '-2.2');
+		equal(Decimal('-1.5').multiply('1.5', 1, 'floor'), '-2.3');
+		equal(Decimal('1.5').multiply(2, 4), '3.0000');
+		equal(Decimal('0.000000000000000001').multiply('0.000000000000000001'), '0.000000000000000000');
+		equal(Decimal('0.000000000000000001').multiply('0.000000000000000001', 0, 'expand'), '1');
+		equal(Decimal('0.000000000000000005').multiply('0.1', 18, 'halfEven'), '0.000000000000000000');
+		equal(Decimal('0.000000000000000005').multiply('0.100000000000000001', 18, 'halfEven'), '0.000000000000000001');
+		equal(Decimal('3037000499').multiply('3037000499'), '9223372030926249001');
+		equal(Decimal('3037000.499').multiply('3037000.499', 1, 'halfExpand'), '9223372030926.2');
+		expect(() => Decimal('3037000500').multiply('3037000500')).to.throw(RangeError);
+		expect(() => Decimal(Integer.MAX_VALUE).multiply(1, 1)).to.throw(RangeError);
+	});
+	it('should divide with rounding', function () {
+		equal(Decimal('10.00').divide(3), '3.33');
+		equal(Decimal('10.00').divide(3, 4, 'halfExpand'), '3.3333');
+		equal(Decimal('2').divide(3, 2, 'halfExpand'), '0.67');
+		equal(Decimal('-2').divide(3, 2, 'floor'), '-0.67');
+		equal(Decimal('1').divide('0.001'), '1000.000');
+		equal(Decimal('9.2').divide('0.000000000000000001', 0), '9200000000000000000');
+		equal(Decimal(1).divide('3.000000000000000000', 18, 'halfExpand'), '0.333333333333333333');
+		equal(Decimal(2).divide('3.000000000000000000', 18, 'halfExpand'), '0.666666666666666667');
+		equal(Decimal('1').divide('1000000000000000000', 0, 'ceil'), '1');
+		equal(Decimal('1').divide('1000000000000000000', 0, 'halfExpand'), '0');
+		equal(Decimal('-1').divide('1000000000000000000', 0, 'floor'), '-1');
+		equal(Decimal('0').divide('-1000000000000000000', 0, 'expand'), '0');
+		expect(() => Decimal(1).divide(0)).to.throw(RangeError);
+		expect(() => Decimal(1).divide('0.00')).to.throw(RangeError);
+		expect(() => Decimal(Integer.MAX_VALUE).divide('0.5')).to.throw(RangeError);
+	});
+	it('should be rescaled with rounding', function () {
+		equal(Decimal('1.005').rescale(2, 'halfEven'), '1.00');
+		equal(Decimal('1.015').rescale(2, 'halfEven'), '1.02');
+		equal(Decimal('-1.005').rescale(2, 'halfExpand'), '-1.01');
+		equal(Decimal('1.5').rescale(4), '1.5000');
+		const decimal = Decimal('1.5');
+		expect(decimal.rescale(1)).to.equal(decimal);
+		expect(() => decimal.rescale()).to.throw(TypeError);
+		expect(() => Decimal('92233720368547758.07').rescale(3)).to.throw(RangeError);
+	});
+	it('should be compared by value', function () {
+		expect(Decimal('1.5').equals('1.50')).to.be.true;
+		expect(Decimal('1.5').equals(Decimal('1.49'))).to.be.false;
+		expect(Decimal('1.5').compare('1.49')).to.equal(1);
+		expect(Decimal('-1.5').compare('-1.49')).to.equal(-1);
+		expect(Decimal('-0.000000000000000001').compare(0)).to.equal(-1);
+		expect(Decimal(Integer.MAX_VALUE).compare(Decimal.fromMantissa(Integer.MAX_VALUE, 18))).to.equal(1);
+		expect(Decimal('-1').lessThan(0)).to.be.true;
+		expect(Decimal('0.1').greaterThan('0.09')).to.be.true;
+		expect(Decimal('0.00').isZero()).to.be.true;
+		expect(Decimal('-0.01').isNegative()).to.be.true;
+		expect(Decimal('0.01').isPositive()).to.be.true;
+	});
+	it('should be negated and converted', function () {
+		equal(Decimal('1.50').negate(), '-1.50');
+		equal(Decimal('-1.50').abs(), '1.50');
+		expect(() => Decimal.fromMantissa(Integer.MIN_VALUE, 2).negate()).to.throw(RangeError);
+		expect(Decimal('0.1').add('0.2').toNumber()).to.equal(0.3);
+		expect(Decimal('-1234.5678').toNumber()).to.equal(-1234.5678);
+	});
+	it('should not be mistaken for an Integer', function () {
+		const decimal = Decimal('1.5');
+		expect(Decimal.isInstance(decimal)).to.be.true;
+		expect(Integer.isInstance(decimal)).to.be.false;
+		expect(Decimal.isInstance(Integer(1))).to.be.false;
+		expect(Decimal.isInstance('1.5')).to.be.false;
+		expect(Decimal.isInstance(new Integer.SharedArray(1))).to.be.false;
+		expect(() => Integer(1).add(decimal)).to.throw(TypeError);
+		expect(() => Decimal.prototype.add.call(Integer(1), 1)).to.throw(TypeError);
+	});
+});